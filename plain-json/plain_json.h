@@ -4,10 +4,15 @@
 #ifndef _PLAIN_JSON_H_
     #define _PLAIN_JSON_H_
 
+    /* Default nesting limit, if "plain_json_Options.max_depth" is 0. Raising it does not grow
+     * the context, levels past the inline capacity are kept in allocated memory. */
     #ifndef PLAIN_JSON_OPTION_MAX_DEPTH
         #define PLAIN_JSON_OPTION_MAX_DEPTH 32
     #endif
 
+    /* Define PLAIN_JSON_OPTION_FLOAT32 to parse real numbers as PLAIN_JSON_TYPE_FLOAT32 instead
+     * of PLAIN_JSON_TYPE_FLOAT64. */
+
 /// If the error_code is not equal to PLAIN_JSON_DONE, the parser encountered an issue.
 /// "plain-json" tries to be explicit when it comes to error handeling, meaning most
 /// uniq parsing issues have a seperate error code.
@@ -16,6 +21,8 @@ typedef enum {
 
     PLAIN_JSON_DONE,
     PLAIN_JSON_HAS_REMAINING,
+    /// The fixed token or string buffer is full, see "plain_json_resume()".
+    PLAIN_JSON_BUFFER_FULL,
 
     PLAIN_JSON_ERROR_NO_MEMORY,
 
@@ -45,6 +52,15 @@ typedef enum {
     PLAIN_JSON_ERROR_UNEXPECTED_COMMA,
     PLAIN_JSON_ERROR_UNEXPECTED_ROOT,
     PLAIN_JSON_ERROR_ILLEGAL_CHAR,
+
+    /// The JSON Pointer given to "plain_json_pointer_compile()" is malformed.
+    PLAIN_JSON_ERROR_POINTER_INVALID,
+    /// The JSONPath given to "plain_json_query_compile()" is malformed or not supported, or a
+    /// query was passed to a context from "plain_json_create_fixed()".
+    PLAIN_JSON_ERROR_QUERY_INVALID,
+    /// The field mask given to "plain_json_mask_compile()" is malformed, or a mask was passed
+    /// to a context from "plain_json_create_fixed()".
+    PLAIN_JSON_ERROR_MASK_INVALID,
 } plain_json_ErrorType;
 
 /// The token type.
@@ -71,6 +87,35 @@ typedef enum {
     #define PLAIN_JSON_NO_KEY (-1U)
     #define PLAIN_JSON_NULL   ((void *)0)
 
+/// A tokens value. Check the tokens type to figure out the correct field.
+typedef union {
+    /// The internal index of this tokens string value (if any).
+    /// See 'plain_json_get_string()'
+    uint32_t string_index;
+    uint64_t integer;
+    float float32;
+    double float64;
+    /// Object and array start tokens, see 'plain_json_skip()'.
+    struct {
+        /// The index of the matching end token.
+        uint32_t end_index;
+        /// The number of direct members or elements.
+        uint32_t child_count;
+    } container;
+    /// Object and array end tokens, see "plain_json_Cursor".
+    struct {
+        /// The start token of the enclosing container, PLAIN_JSON_NO_KEY at the root.
+        uint32_t parent_index;
+    } container_end;
+} plain_json_Value;
+
+/// A key or string value and its length in bytes. Strings may contain NUL characters (decoded
+/// from "\u0000") and, with PLAIN_JSON_FLAG_ZERO_COPY, are not necessarily NUL terminated.
+typedef struct {
+    const uint8_t *data;
+    uint32_t length;
+} plain_json_String;
+
 /// A tokens fields describe its layout. All fields can (and should) be
 /// accessed directly. The library only hands out const references that
 /// should be treated as read-only
@@ -83,16 +128,17 @@ typedef struct {
     uint32_t key_index;
     /// Check the type to figure the correct value type.
     plain_json_Type type;
-    union {
-        /// The internal index of this tokens string value (if any).
-        /// See 'plain_json_get_string()'
-        uint32_t string_index;
-        uint64_t integer;
-        float float32;
-        double float64;
-    } value;
+    plain_json_Value value;
 } plain_json_Token;
 
+/// The 16 byte layout tokens are stored in with PLAIN_JSON_FLAG_COMPACT_TOKENS. It drops the
+/// "start" and "length" fields, except for the error token, whose value holds its start.
+typedef struct {
+    plain_json_Value value;
+    uint32_t key_index;
+    uint8_t type;
+} plain_json_CompactToken;
+
 typedef struct {
     void *context;
     void *(*alloc_func)(void *context, uintptr_t size);
@@ -104,6 +150,91 @@ typedef struct {
 /// library functions.
 typedef struct plain_json_Context plain_json_Context;
 
+/// A compiled JSONPath query, see "plain_json_query_compile()".
+typedef struct plain_json_Query plain_json_Query;
+
+/// A compiled field mask, see "plain_json_mask_compile()".
+typedef struct plain_json_Mask plain_json_Mask;
+
+/// Optional parser settings. Zero initialize the struct and only set the fields you need.
+typedef struct {
+    /// Expected number of tokens. The token buffer is reserved up front if this is not 0.
+    uint32_t token_count_hint;
+    /// Expected size of all keys and string values in bytes. Each of them takes up its
+    /// length plus a 4 byte header and 1 to 4 bytes of padding, keys another 4 bytes for
+    /// their hash. Reserved up front if this is not 0.
+    uintptr_t string_size_hint;
+    /// Combination of the "PLAIN_JSON_FLAG_*" values below.
+    uint32_t flags;
+    /// Maximum number of nested objects and arrays, "PLAIN_JSON_OPTION_MAX_DEPTH" if 0.
+    /// Contexts from "plain_json_create_fixed()" support at most 128 levels.
+    uint32_t max_depth;
+    /// Only keep the values selected by a compiled query. The token buffer then holds each
+    /// selected value (including its members or elements) one after another, in document order.
+    /// Use "plain_json_skip()" to step from one to the next. Everything else is still
+    /// validated, but neither stored as a token nor copied into the string buffer.
+    /// Not supported by contexts from "plain_json_create_fixed()", parsing fails with
+    /// PLAIN_JSON_ERROR_QUERY_INVALID.
+    const plain_json_Query *query;
+    /// Only keep the object members selected by a compiled field mask. The values of all other
+    /// members are skipped without creating tokens or copying strings. Skipped strings, numbers
+    /// and keywords are validated like kept ones. Skipped objects and arrays are only checked
+    /// for balanced brackets, unescaped quotes and "max_depth": keywords, numbers, escapes,
+    /// UTF-8, commas and colons inside of them are not validated.
+    /// Not supported by contexts from "plain_json_create_fixed()", parsing fails with
+    /// PLAIN_JSON_ERROR_MASK_INVALID.
+    const plain_json_Mask *mask;
+} plain_json_Options;
+
+/// Scan the buffer once before parsing, to allocate the token and string buffers in one go.
+/// Replaces the size hints. Trades a quick extra pass for fewer (and predictable) allocations.
+    #define PLAIN_JSON_FLAG_EXACT_SIZE (1U << 0)
+/// Strings without escapes reference the input buffer instead of being copied, which then has
+/// to outlive the context. Such strings are not NUL terminated, see
+/// "plain_json_get_string_length()".
+    #define PLAIN_JSON_FLAG_ZERO_COPY (1U << 1)
+/// Store tokens as "plain_json_CompactToken" (16 instead of 32 bytes per token).
+    #define PLAIN_JSON_FLAG_COMPACT_TOKENS (1U << 2)
+/// Store each distinct key only once, so tokens with equal keys share their "key_index".
+/// Keys can then be compared by their index.
+    #define PLAIN_JSON_FLAG_INTERN_KEYS (1U << 3)
+
+/// A position in the token tree, to walk it with "plain_json_cursor_first_child()",
+/// "plain_json_cursor_next_sibling()" and "plain_json_cursor_parent()" in O(1) per step.
+/// All fields can be read directly.
+typedef struct {
+    /// The current token.
+    uint32_t index;
+    /// The start token of the enclosing object or array, PLAIN_JSON_NO_KEY at the root.
+    uint32_t parent;
+    /// The number of enclosing objects and arrays.
+    uint32_t depth;
+} plain_json_Cursor;
+
+/// A compiled RFC 6901 JSON Pointer, see "plain_json_pointer_compile()".
+typedef struct plain_json_Pointer plain_json_Pointer;
+typedef struct plain_json_ArenaChunk plain_json_ArenaChunk;
+
+/// A bump allocator, usable through "plain_json_arena_allocator()". Allocations are carved
+/// out of a caller provided buffer and, once that is exhausted, out of chunks requested from a
+/// backing allocator. Resizing the most recent allocation happens in place and everything is
+/// released at once by "plain_json_arena_reset()". Not thread safe, use one arena per thread.
+/// All fields are internal.
+typedef struct {
+    uint8_t *buffer;
+    uintptr_t buffer_size;
+    uintptr_t offset;
+    uintptr_t last_offset;
+
+    uint8_t *initial_buffer;
+    uintptr_t initial_size;
+
+    plain_json_ArenaChunk *chunks;
+    plain_json_ArenaChunk *spare;
+    bool has_backing;
+    plain_json_AllocatorConfig backing;
+} plain_json_Arena;
+
 /// Fully parse the given text buffer. The function requires a "plain_json_ErrorType"
 /// argument that should be initialized to "PLAIN_JSON_NONE".
 /// Check the last token to track down the errors exact position.
@@ -111,13 +242,151 @@ extern plain_json_Context *plain_json_parse(
     plain_json_AllocatorConfig alloc_config, const uint8_t *buffer, uintptr_t buffer_size,
     plain_json_ErrorType *error
 );
+/// Same as "plain_json_parse()", with additional settings.
+extern plain_json_Context *plain_json_parse_with_options(
+    plain_json_AllocatorConfig alloc_config, plain_json_Options options, const uint8_t *buffer,
+    uintptr_t buffer_size, plain_json_ErrorType *error
+);
+
+/// Create an empty context, to parse several documents one after another with
+/// "plain_json_parse_into()". The token and string buffers are kept between documents,
+/// so parsing stops allocating once they are large enough. Returns NULL if the allocation fails.
+extern plain_json_Context *plain_json_create(plain_json_AllocatorConfig alloc_config);
+/// Parse a document into an existing context. The results of the previous document are
+/// discarded. Returns the same status as "plain_json_parse()".
+extern plain_json_ErrorType plain_json_parse_into(
+    plain_json_Context *context, plain_json_Options options, const uint8_t *buffer,
+    uintptr_t buffer_size
+);
+/// Same as "plain_json_parse_into()", but decodes strings in place, overwriting the given
+/// buffer. All keys and string values then point into the buffer (which has to outlive the
+/// context) and are NUL terminated. The string buffer only holds a small reference per string.
+/// "plain_json_compute_position()" may be off after decoded escapes.
+extern plain_json_ErrorType plain_json_parse_in_situ(
+    plain_json_Context *context, plain_json_Options options, uint8_t *buffer, uintptr_t buffer_size
+);
+/// Discard the parsing results, but keep the allocated buffers.
+extern void plain_json_reset(plain_json_Context *context);
+/// Get the size of a context in bytes, for "plain_json_create_fixed()".
+extern uintptr_t plain_json_context_size(void);
+/// Create a context in caller provided memory, that never allocates. Tokens and strings are
+/// stored in the given fixed size buffers. Once either of them is full, parsing stops with
+/// PLAIN_JSON_BUFFER_FULL. Returns NULL if 'memory' is smaller than "plain_json_context_size()"
+/// (plus alignment). "plain_json_free()" does nothing for such contexts.
+/// The size hints, PLAIN_JSON_FLAG_EXACT_SIZE and PLAIN_JSON_FLAG_INTERN_KEYS are ignored,
+/// queries and field masks are rejected.
+extern plain_json_Context *plain_json_create_fixed(
+    void *memory, uintptr_t memory_size, void *token_buffer, uintptr_t token_buffer_size,
+    void *string_buffer, uintptr_t string_buffer_size
+);
+/// Continue parsing after PLAIN_JSON_BUFFER_FULL. All tokens and strings are discarded, so
+/// process them first. Token indices start at 0 again. Returns the same status as
+/// "plain_json_parse_into()", or PLAIN_JSON_ERROR_NO_MEMORY if a single token does not fit
+/// into the empty buffers.
+extern plain_json_ErrorType plain_json_resume(plain_json_Context *context);
 /// Release the internal state, after processing the parsing results.
 extern void plain_json_free(plain_json_Context *context);
 
+/// Initialize an arena over 'buffer' (which may be NULL). If 'backing' is not NULL, it is used
+/// to allocate additional chunks. Otherwise allocations fail once the buffer is full.
+extern void plain_json_arena_init(
+    plain_json_Arena *arena, void *buffer, uintptr_t buffer_size,
+    const plain_json_AllocatorConfig *backing
+);
+/// Get an allocator config that allocates from the given arena.
+extern plain_json_AllocatorConfig plain_json_arena_allocator(plain_json_Arena *arena);
+/// Release all allocations at once. Allocation restarts in the caller provided buffer and only
+/// the most recent chunk is kept to follow it, so an arena that is reset between documents
+/// stops allocating once it is large enough.
+/// Contexts allocated from the arena must not be used afterwards.
+extern void plain_json_arena_reset(plain_json_Arena *arena);
+/// Return all chunks to the backing allocator.
+extern void plain_json_arena_release(plain_json_Arena *arena);
+
 /// Get the total token count.
 extern uint32_t plain_json_get_token_count(plain_json_Context *context);
 /// Get a specific token, given its index. Tokens are stored in order.
+/// With PLAIN_JSON_FLAG_COMPACT_TOKENS, the token is expanded into a buffer inside of the
+/// context, which is overwritten by the next call.
 extern const plain_json_Token *plain_json_get_token(plain_json_Context *context, uint32_t index);
+/// Get the type of a specific token. Cheaper than "plain_json_get_token()" for scans, since it
+/// does not expand compact tokens. Returns PLAIN_JSON_TYPE_INVALID if the index is invalid.
+extern plain_json_Type plain_json_get_type(plain_json_Context *context, uint32_t index);
+/// Get the index of the token after the given tokens subtree in O(1). For object and array
+/// start tokens, that is the token after their end token, for all others the next token.
+/// Returns the token count if the subtree is not complete (because parsing failed, or its end
+/// was discarded by "plain_json_resume()").
+extern uint32_t plain_json_skip(plain_json_Context *context, uint32_t index);
+
+/// Point the cursor at the root value. Returns false if there are no tokens.
+extern bool plain_json_cursor_root(plain_json_Context *context, plain_json_Cursor *cursor);
+/// Move the cursor to the first member of an object or element of an array.
+/// Returns false (and leaves the cursor as is) if the token is not a non-empty container.
+extern bool plain_json_cursor_first_child(plain_json_Context *context, plain_json_Cursor *cursor);
+/// Move the cursor to the next member or element of the enclosing container.
+/// Returns false (and leaves the cursor as is) if it is the last one.
+extern bool plain_json_cursor_next_sibling(plain_json_Context *context, plain_json_Cursor *cursor);
+/// Move the cursor to the enclosing container. Returns false (and leaves the cursor as is) at
+/// the root, or if the container is incomplete.
+extern bool plain_json_cursor_parent(plain_json_Context *context, plain_json_Cursor *cursor);
+
+/// Find the member of an object with the given key, given the index of its start token.
+/// Returns the members token index, or PLAIN_JSON_NO_KEY if there is no such member (or the
+/// token is not a complete object). The first lookup on a large object builds an index of its
+/// members inside of the context, later lookups take O(1). If a key occurs more than once, the
+/// first member is returned.
+extern uint32_t plain_json_object_get(
+    plain_json_Context *context, uint32_t object_index, const uint8_t *key, uint32_t length
+);
+/// Find an element of an array, given the index of its start token. Returns the elements token
+/// index, or PLAIN_JSON_NO_KEY if the array is too short (or the token is not a complete array).
+/// Takes O(1) for arrays of scalars and one skip per preceding element otherwise.
+extern uint32_t
+plain_json_array_get(plain_json_Context *context, uint32_t array_index, uint32_t element);
+
+/// Compile a JSON Pointer like "/payload/items/12/price" (RFC 6901) for
+/// "plain_json_pointer_get()". The reference tokens are unescaped ("~0" and "~1") and array
+/// indices are parsed once. Sets 'error' to PLAIN_JSON_DONE on success, or returns NULL with
+/// PLAIN_JSON_ERROR_POINTER_INVALID or PLAIN_JSON_ERROR_NO_MEMORY.
+extern plain_json_Pointer *plain_json_pointer_compile(
+    plain_json_AllocatorConfig alloc_config, const uint8_t *pointer, uint32_t length,
+    plain_json_ErrorType *error
+);
+/// Evaluate a compiled pointer, relative to the token at 'index' (0 for the whole document).
+/// Returns the index of the referenced token, or PLAIN_JSON_NO_KEY if it does not exist.
+/// Only the containers along the path are visited, subtrees next to it are skipped.
+extern uint32_t plain_json_pointer_get(
+    plain_json_Context *context, const plain_json_Pointer *pointer, uint32_t index
+);
+/// Release a compiled pointer.
+extern void plain_json_pointer_free(plain_json_Pointer *pointer);
+
+/// Compile a JSONPath query for "plain_json_Options.query". Supported is a subset of
+/// JSONPath: the root "$", followed by any number of child segments (".name", "['name']",
+/// ".*", "[*]", "[3]" or slices like "[1:5]", "[2:]" and "[::2]") and descendant segments
+/// ("..name", "..*", "..[0]"). Dot notation names consist of letters, digits, '_' and non
+/// ASCII characters and do not start with a digit, others need quotes. Indices can not be
+/// negative and there can be at most 63 segments. Sets 'error' to PLAIN_JSON_DONE on success,
+/// or returns NULL with PLAIN_JSON_ERROR_QUERY_INVALID or PLAIN_JSON_ERROR_NO_MEMORY.
+extern plain_json_Query *plain_json_query_compile(
+    plain_json_AllocatorConfig alloc_config, const uint8_t *query, uint32_t length,
+    plain_json_ErrorType *error
+);
+/// Release a compiled query. It must not be used by a parser anymore.
+extern void plain_json_query_free(plain_json_Query *query);
+
+/// Compile a field mask for "plain_json_Options.mask". It is a comma separated list of key
+/// paths, each of them a dot separated list of keys, e.g. "id,user.name,events.type". A member
+/// is kept if its path is in the mask (with everything below it), or leads to a path in the
+/// mask. Arrays are transparent: the paths continue in each of their elements. A '\\' escapes
+/// the next character of a key. Sets 'error' to PLAIN_JSON_DONE on success, or returns NULL
+/// with PLAIN_JSON_ERROR_MASK_INVALID or PLAIN_JSON_ERROR_NO_MEMORY.
+extern plain_json_Mask *plain_json_mask_compile(
+    plain_json_AllocatorConfig alloc_config, const uint8_t *mask, uint32_t length,
+    plain_json_ErrorType *error
+);
+/// Release a compiled field mask. It must not be used by a parser anymore.
+extern void plain_json_mask_free(plain_json_Mask *mask);
 
 /// Get a tokens key (if any), given a tokens "key_index" field.
 /// Returns NULL if the token does not have a key.
@@ -127,6 +396,27 @@ extern const uint8_t *plain_json_get_key(plain_json_Context *context, uint32_t k
 /// produce misleadingerrornous results.
 /// Returns NULL if the string index is invalid.
 extern const uint8_t *plain_json_get_string(plain_json_Context *context, uint32_t string_index);
+/// Get the length of a key or string value in bytes, given its "key_index" or "string_index".
+/// Returns 0 if the index is invalid.
+extern uint32_t plain_json_get_string_length(plain_json_Context *context, uint32_t string_index);
+/// Same as "plain_json_get_key()", but also returns the length.
+/// The result is { NULL, 0 } if the token does not have a key.
+extern plain_json_String plain_json_get_key_view(plain_json_Context *context, uint32_t key_index);
+/// Same as "plain_json_get_string()", but also returns the length.
+/// The result is { NULL, 0 } if the string index is invalid.
+extern plain_json_String
+plain_json_get_string_view(plain_json_Context *context, uint32_t string_index);
+/// Check whether a tokens key is equal to the given 'length' bytes of 'key'.
+/// Returns false if the token does not have a key.
+extern bool plain_json_key_equals(
+    plain_json_Context *context, uint32_t key_index, const uint8_t *key, uint32_t length
+);
+/// Get the hash of a tokens key, which the parser computes while reading it.
+/// Equal keys have equal hashes. Returns 0 if the token does not have a key.
+extern uint32_t plain_json_get_key_hash(plain_json_Context *context, uint32_t key_index);
+/// Hash 'length' bytes of 'key' the same way the parser hashes keys, to compare the result
+/// with "plain_json_get_key_hash()".
+extern uint32_t plain_json_hash(const uint8_t *key, uint32_t length);
 
 /// Turn a tokens offset field into an absolute position.
 /// Requires a "line" and "line_offset" argument to store the result.
@@ -162,22 +452,95 @@ extern const char *plain_json_type_to_string(plain_json_Type type);
         #define json_assert(...)
     #endif
 
+    /* The block classifier and UTF-8 validation use SSE2 to AVX-512 on x86, selected at
+     * runtime. Define PLAIN_JSON_NO_SIMD to only build the scalar fallback. */
+    #if !defined(PLAIN_JSON_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) && \
+        defined(__GNUC__)
+        #define PLAIN_JSON_SIMD_X86
+        #include <immintrin.h>
+    #endif
+
     #define is_blank(c) (c == ' ' || c == '\t' || c == '\n' || c == '\r')
     #define is_digit(c) (c >= '0' && c <= '9')
     #define is_hex(c)   ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (is_digit(c)))
 
     #define PLAIN_JSON_TOKEN_PAGESIZE   16
+    #define PLAIN_JSON_ARENA_CHUNKSIZE  4096
+    #define PLAIN_JSON_ARENA_ALIGNMENT  16
     #define PLAIN_JSON_STRING_PAGESIZE  128
     #define PLAIN_JSON_STRING_CACHESIZE 64
-
-    #define PLAIN_JSON_STATE_IS_FIRST_TOKEN 0x01
-    #define PLAIN_JSON_STATE_IS_ROOT        0x02
-
-    #define PLAIN_JSON_STATE_NEEDS_KEY         0x04
-    #define PLAIN_JSON_STATE_NEEDS_COMMA       0x08
-    #define PLAIN_JSON_STATE_NEEDS_VALUE       0x10
-    #define PLAIN_JSON_STATE_NEEDS_ARRAY_VALUE 0x20
-    #define PLAIN_JSON_STATE_NEEDS_COLON       0x40
+    #define PLAIN_JSON_STRING_REFERENCE 0x80000000
+    #define PLAIN_JSON_KEY_TABLE_SIZE   64
+    #define PLAIN_JSON_DEPTH_INLINE     2
+    #define PLAIN_JSON_MEMBER_TABLE_SIZE 64
+    /* Objects with fewer members are searched linearly */
+    #define PLAIN_JSON_MEMBER_INDEX_MIN 16
+
+    #define PLAIN_JSON_BLOCKSIZE        64
+
+    #define PLAIN_JSON_DECIMAL_DIGITS    800
+    #define PLAIN_JSON_DECIMAL_MAX_SHIFT 27
+
+    /* Error bits of the vectorized UTF-8 validation, named after the defect they detect */
+    #define PLAIN_JSON_UTF8_TOO_SHORT      0x01
+    #define PLAIN_JSON_UTF8_TOO_LONG       0x02
+    #define PLAIN_JSON_UTF8_OVERLONG_3     0x04
+    #define PLAIN_JSON_UTF8_TOO_LARGE      0x08
+    #define PLAIN_JSON_UTF8_SURROGATE      0x10
+    #define PLAIN_JSON_UTF8_OVERLONG_2     0x20
+    #define PLAIN_JSON_UTF8_TOO_LARGE_1000 0x40
+    #define PLAIN_JSON_UTF8_OVERLONG_4     0x40
+    #define PLAIN_JSON_UTF8_TWO_CONTS      0x80
+    #define PLAIN_JSON_UTF8_CARRY \
+        (PLAIN_JSON_UTF8_TOO_SHORT | PLAIN_JSON_UTF8_TOO_LONG | PLAIN_JSON_UTF8_TWO_CONTS)
+
+    /* Parser states, one per nesting level. Whatever the state expects next is noted in the
+     * comments, anything else is an error. */
+    #define PLAIN_JSON_STATE_ROOT_START   0 /* The root value */
+    #define PLAIN_JSON_STATE_ROOT_END     1 /* Nothing but blanks */
+    #define PLAIN_JSON_STATE_OBJECT_START 2 /* A key or '}' */
+    #define PLAIN_JSON_STATE_OBJECT_KEY   3 /* A key, following a ',' */
+    #define PLAIN_JSON_STATE_OBJECT_COLON 4 /* ':' */
+    #define PLAIN_JSON_STATE_OBJECT_VALUE 5 /* A value */
+    #define PLAIN_JSON_STATE_OBJECT_COMMA 6 /* ',' or '}' */
+    #define PLAIN_JSON_STATE_ARRAY_START  7 /* A value or ']' */
+    #define PLAIN_JSON_STATE_ARRAY_VALUE  8 /* A value, following a ',' */
+    #define PLAIN_JSON_STATE_ARRAY_COMMA  9 /* ',' or ']' */
+    #define PLAIN_JSON_STATE_COUNT        10
+
+    /* Character classes, blanks are skipped before looking up the class */
+    #define PLAIN_JSON_CLASS_OTHER        0
+    #define PLAIN_JSON_CLASS_OBJECT_START 1
+    #define PLAIN_JSON_CLASS_OBJECT_END   2
+    #define PLAIN_JSON_CLASS_ARRAY_START  3
+    #define PLAIN_JSON_CLASS_ARRAY_END    4
+    #define PLAIN_JSON_CLASS_COMMA        5
+    #define PLAIN_JSON_CLASS_COLON        6
+    #define PLAIN_JSON_CLASS_QUOTE        7
+    #define PLAIN_JSON_CLASS_KEYWORD      8
+    #define PLAIN_JSON_CLASS_NUMBER       9
+    #define PLAIN_JSON_CLASS_COUNT        10
+
+    /* Actions of a state transition. The lower nibble of a transition holds the action, the
+     * upper one the next state of the current nesting level. */
+    #define PLAIN_JSON_ACTION_ILLEGAL_CHAR     0
+    #define PLAIN_JSON_ACTION_MISSING_COMMA    1
+    #define PLAIN_JSON_ACTION_UNEXPECTED_COMMA 2
+    #define PLAIN_JSON_ACTION_OBJECT_START     3
+    #define PLAIN_JSON_ACTION_OBJECT_END       4
+    #define PLAIN_JSON_ACTION_ARRAY_START      5
+    #define PLAIN_JSON_ACTION_ARRAY_END        6
+    #define PLAIN_JSON_ACTION_COMMA            7
+    #define PLAIN_JSON_ACTION_COLON            8
+    #define PLAIN_JSON_ACTION_KEY              9
+    #define PLAIN_JSON_ACTION_STRING           10
+    #define PLAIN_JSON_ACTION_KEYWORD          11
+    #define PLAIN_JSON_ACTION_NUMBER           12
+
+    /* Actions are dispatched with computed goto (a GNU extension) where available */
+    #ifdef __GNUC__
+        #define PLAIN_JSON_COMPUTED_GOTO
+    #endif
 
 typedef struct {
     uint32_t item_size;
@@ -187,14 +550,161 @@ typedef struct {
     uint8_t *buffer;
 } plain_json_List;
 
+typedef struct {
+    uint32_t hash;
+    uint32_t key_index;
+} plain_json_KeySlot;
+
+/* An object member in the lookup index of "plain_json_object_get()". An object that has been
+ * indexed has an extra slot with 'member' equal to 'object'. */
+typedef struct {
+    uint32_t hash;
+    uint32_t object;
+    uint32_t member;
+} plain_json_MemberSlot;
+
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t hash;
+    /* The reference token as an array index, PLAIN_JSON_NO_KEY if it is none */
+    uint32_t index;
+} plain_json_PointerSegment;
+
+struct plain_json_Pointer {
+    plain_json_AllocatorConfig alloc_config;
+    uint32_t segment_count;
+    plain_json_PointerSegment *segments;
+    uint8_t *names;
+};
+
+    #define PLAIN_JSON_SELECTOR_NAME     0
+    #define PLAIN_JSON_SELECTOR_WILDCARD 1
+    #define PLAIN_JSON_SELECTOR_SLICE    2
+
+/* A single index is the slice [index:index + 1] */
+typedef struct {
+    uint8_t selector;
+    bool descendant;
+    uint32_t offset;
+    uint32_t length;
+    uint32_t hash;
+    uint32_t start;
+    uint32_t end;
+    uint32_t step;
+} plain_json_QuerySegment;
+
+struct plain_json_Query {
+    plain_json_AllocatorConfig alloc_config;
+    uint32_t segment_count;
+    plain_json_QuerySegment *segments;
+    uint8_t *names;
+};
+
+/* The segments a query has matched so far, for the members or elements of an open container.
+ * Bit 'n' is set if the first 'n' segments match the path to the container. */
+typedef struct {
+    uint64_t positions;
+    uint32_t element_index;
+} plain_json_QueryLevel;
+
+/* A key of a field mask. The keys of all paths form a tree, with the root as node 0. A node
+ * that ends a path keeps everything below it. */
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t hash;
+    uint32_t first_child;
+    uint32_t next_sibling;
+    bool keep_all;
+} plain_json_MaskNode;
+
+struct plain_json_Mask {
+    plain_json_AllocatorConfig alloc_config;
+    uint32_t node_count;
+    plain_json_MaskNode *nodes;
+    uint8_t *names;
+};
+
+struct plain_json_ArenaChunk {
+    plain_json_ArenaChunk *prev;
+    uintptr_t size;
+};
+
+/// Character classes of a single 64 byte block. Bit 'n' of each mask corresponds to byte 'n'
+/// of the block.
+typedef struct {
+    uint64_t blank;
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t control;
+    uint64_t structural;
+    uint64_t non_ascii;
+} plain_json_BlockMask;
+
+typedef void (*plain_json_ClassifyFunc)(const uint8_t *block, plain_json_BlockMask *mask);
+typedef plain_json_ErrorType (*plain_json_ValidateFunc)(const uint8_t *buffer, uintptr_t buffer_size);
+
 struct plain_json_Context {
     const uint8_t *buffer;
 
     uintptr_t buffer_size;
     uintptr_t buffer_offset;
 
-    uint8_t depth_buffer_index;
-    uint8_t depth_buffer[PLAIN_JSON_OPTION_MAX_DEPTH];
+    /* The most recently classified block. The index is computed lazily, since most lookups
+     * hit the same block as the previous one. */
+    plain_json_ClassifyFunc classify;
+    plain_json_ValidateFunc validate_utf8;
+    uintptr_t block_offset;
+    plain_json_BlockMask block;
+
+    /* The nesting stack stores one bit per open container (set for objects), the state of the
+     * innermost level is derived from it when a container is closed. The first 64 *
+     * PLAIN_JSON_DEPTH_INLINE levels live in the context, deeper ones in "depth_spill". */
+    uint8_t state;
+    uint32_t depth;
+    uint32_t max_depth;
+    uint32_t depth_capacity;
+    uint64_t *depth_spill;
+    uint64_t depth_inline[PLAIN_JSON_DEPTH_INLINE];
+
+    /* With a query, values below "query_emit_depth" are all kept and values below
+     * "query_dead_depth" can not be selected anymore. "query_keep" is set for each value. */
+    const plain_json_Query *query;
+    uint32_t query_emit_depth;
+    uint32_t query_dead_depth;
+    uint64_t query_positions;
+    bool query_keep;
+    plain_json_List query_levels;
+
+    /* With a field mask, "mask_node" is the node of the innermost open container and
+     * "mask_value" the node of the value that is read next (PLAIN_JSON_NO_KEY if it is
+     * skipped). "mask_levels" holds the node of each open container. */
+    const plain_json_Mask *mask;
+    uint32_t mask_node;
+    uint32_t mask_value;
+    plain_json_List mask_levels;
+
+    /* The innermost open container start token. Levels up to "drained_depth" were discarded by
+     * "plain_json_resume()", so their start tokens can not be linked. */
+    uint32_t container;
+    uint32_t drained_depth;
+
+    uint32_t flags;
+    bool fixed;
+    /* Set by "plain_json_parse_in_situ()", kept apart from the caller's flags */
+    bool in_situ;
+    plain_json_Token expanded_token;
+
+    /* Open addressing table of all distinct keys, with PLAIN_JSON_FLAG_INTERN_KEYS */
+    plain_json_KeySlot *key_slots;
+    uint32_t key_slot_count;
+    uint32_t key_count;
+
+    /* Open addressing table of the members of large objects, built by "plain_json_object_get()" */
+    plain_json_MemberSlot *member_slots;
+    uint32_t member_slot_count;
+    uint32_t member_count;
 
     plain_json_AllocatorConfig alloc_config;
     plain_json_List string_buffer;
@@ -210,11 +720,45 @@ static void *plain_json_intern_memset(void *start, int value, uintptr_t length)
 }
 
 static void *plain_json_intern_memcpy(void *dest, const void *src, uintptr_t length) {
+    /* GCC/Clang require memcpy even in freestanding environments, so the builtin does not add a
+     * dependency. It is a lot faster for the bulk copies of string contents. */
+    #ifdef __GNUC__
+    return __builtin_memcpy(dest, src, length);
+    #else
     while (length--) {
         ((uint8_t *)dest)[length] = ((uint8_t *)src)[length];
     }
 
     return dest;
+    #endif
+}
+
+static int plain_json_intern_memcmp(const void *left, const void *right, uintptr_t length) {
+    #ifdef __GNUC__
+    return __builtin_memcmp(left, right, length);
+    #else
+    for (uintptr_t i = 0; i < length; i++) {
+        const uint8_t a = ((const uint8_t *)left)[i];
+        const uint8_t b = ((const uint8_t *)right)[i];
+        if (a != b) {
+            return a < b ? -1 : 1;
+        }
+    }
+
+    return 0;
+    #endif
+}
+
+/* Only ever moves data towards the start of the buffer */
+static void plain_json_intern_move_down(uint8_t *dest, const uint8_t *src, uintptr_t length) {
+    json_assert(dest <= src);
+    #ifdef __GNUC__
+    __builtin_memmove(dest, src, length);
+    #else
+    for (uintptr_t i = 0; i < length; i++) {
+        dest[i] = src[i];
+    }
+    #endif
 }
 
 static const uint8_t *plain_json_list_get(plain_json_List *list, uint32_t index) {
@@ -225,22 +769,48 @@ static const uint8_t *plain_json_list_get(plain_json_List *list, uint32_t index)
     return list->buffer + list->item_size * index;
 }
 
-static inline bool plain_json_intern_list_append(
-    plain_json_List *list, plain_json_AllocatorConfig *config, void *raw_data, uint32_t count
+/* Make room for at least 'count' items */
+static bool plain_json_intern_list_reserve(
+    plain_json_List *list, plain_json_AllocatorConfig *config, uintptr_t count
 ) {
-    if (list->alloc_size == 0 || (list->item_count + count) * list->item_size > list->alloc_size) {
-        const uintptr_t new_size = list->alloc_size + (list->page_size / count + 1) * list->page_size * list->item_size;
-        list->buffer =
-            config->realloc_func(config->context, list->buffer, list->alloc_size, new_size);
-        list->alloc_size = new_size;
+    const uintptr_t new_size = count * list->item_size;
+    if (new_size <= list->alloc_size) {
+        return true;
     }
 
+    uint8_t *buffer = config->realloc_func(config->context, list->buffer, list->alloc_size, new_size);
+
     // FIXME: This check might not make sense in the context of a custom allocator
-    if (list->buffer == PLAIN_JSON_NULL) {
+    if (buffer == PLAIN_JSON_NULL) {
         return false;
     }
 
-    plain_json_intern_memcpy(list->buffer + list->item_count * list->item_size, raw_data, list->item_size * count);
+    list->buffer = buffer;
+    list->alloc_size = new_size;
+    return true;
+}
+
+static inline bool plain_json_intern_list_append(
+    plain_json_List *list, plain_json_AllocatorConfig *config, const void *raw_data, uint32_t count
+) {
+    const uintptr_t required_count = (uintptr_t)list->item_count + count;
+    if (required_count * list->item_size > list->alloc_size) {
+        /* Double the capacity, so the number of reallocations (and copies) only grows
+         * logarithmically with the document size */
+        uintptr_t new_count = list->alloc_size / list->item_size * 2;
+        if (new_count < list->page_size) {
+            new_count = list->page_size;
+        }
+        if (new_count < required_count) {
+            new_count = required_count;
+        }
+
+        if (!plain_json_intern_list_reserve(list, config, new_count)) {
+            return false;
+        }
+    }
+
+    plain_json_intern_memcpy(list->buffer + (uintptr_t)list->item_count * list->item_size, raw_data, (uintptr_t)list->item_size * count);
     list->item_count += count;
 
     return true;
@@ -262,11 +832,399 @@ static inline uint8_t plain_json_intern_peek(plain_json_Context *context, uintpt
     return context->buffer[context->buffer_offset + offset];
 }
 
+/* Arena allocator */
+
+static inline uintptr_t plain_json_intern_align(uintptr_t value) {
+    return (value + PLAIN_JSON_ARENA_ALIGNMENT - 1) & ~(uintptr_t)(PLAIN_JSON_ARENA_ALIGNMENT - 1);
+}
+
+/* Switch to a new chunk, large enough for 'size' bytes. The rest of the current buffer is
+ * abandoned until the next reset. The chunk kept by the last reset is used first. */
+static bool plain_json_intern_arena_grow(plain_json_Arena *arena, uintptr_t size) {
+    const uintptr_t header_size = plain_json_intern_align(sizeof(plain_json_ArenaChunk));
+    plain_json_ArenaChunk *chunk = arena->spare;
+
+    if (chunk == PLAIN_JSON_NULL || chunk->size < header_size + size) {
+        if (!arena->has_backing) {
+            return false;
+        }
+
+        uintptr_t chunk_size = PLAIN_JSON_ARENA_CHUNKSIZE;
+        if (arena->chunks != PLAIN_JSON_NULL) {
+            chunk_size = arena->chunks->size * 2;
+        } else if (chunk != PLAIN_JSON_NULL) {
+            chunk_size = chunk->size * 2;
+        }
+        if (chunk_size < header_size + size) {
+            chunk_size = header_size + size;
+        }
+
+        /* The spare chunk is too small, replace it */
+        if (chunk != PLAIN_JSON_NULL) {
+            arena->backing.free_func(arena->backing.context, chunk);
+        }
+
+        chunk = arena->backing.alloc_func(arena->backing.context, chunk_size);
+        if (chunk == PLAIN_JSON_NULL) {
+            arena->spare = PLAIN_JSON_NULL;
+            return false;
+        }
+        chunk->size = chunk_size;
+    }
+
+    arena->spare = PLAIN_JSON_NULL;
+    chunk->prev = arena->chunks;
+    arena->chunks = chunk;
+
+    arena->buffer = (uint8_t *)chunk + header_size;
+    arena->buffer_size = chunk->size - header_size;
+    arena->offset = 0;
+    arena->last_offset = 0;
+    return true;
+}
+
+static void *plain_json_intern_arena_alloc(void *context, uintptr_t size) {
+    plain_json_Arena *arena = context;
+    size = plain_json_intern_align(size);
+
+    if (size > arena->buffer_size - arena->offset && !plain_json_intern_arena_grow(arena, size)) {
+        return PLAIN_JSON_NULL;
+    }
+
+    arena->last_offset = arena->offset;
+    arena->offset += size;
+    return arena->buffer + arena->last_offset;
+}
+
+static void *
+plain_json_intern_arena_realloc(void *context, void *buffer, uintptr_t old_size, uintptr_t new_size) {
+    plain_json_Arena *arena = context;
+
+    /* The most recent allocation can simply be extended */
+    if (buffer != PLAIN_JSON_NULL && (uint8_t *)buffer == arena->buffer + arena->last_offset &&
+        plain_json_intern_align(new_size) <= arena->buffer_size - arena->last_offset) {
+        arena->offset = arena->last_offset + plain_json_intern_align(new_size);
+        return buffer;
+    }
+
+    void *result = plain_json_intern_arena_alloc(context, new_size);
+    if (result != PLAIN_JSON_NULL && buffer != PLAIN_JSON_NULL) {
+        plain_json_intern_memcpy(result, buffer, old_size < new_size ? old_size : new_size);
+    }
+
+    return result;
+}
+
+/* Memory is only reclaimed by a reset, unless this was the most recent allocation */
+static void plain_json_intern_arena_free(void *context, void *buffer) {
+    plain_json_Arena *arena = context;
+
+    if ((uint8_t *)buffer == arena->buffer + arena->last_offset) {
+        arena->offset = arena->last_offset;
+    }
+}
+
+/* Block classification */
+
+static inline uint32_t plain_json_intern_ctz64(uint64_t value) {
+    json_assert(value != 0);
+    #ifdef __GNUC__
+    return (uint32_t)__builtin_ctzll(value);
+    #else
+    uint32_t count = 0;
+    while ((value & 1) == 0) {
+        value >>= 1;
+        count++;
+    }
+    return count;
+    #endif
+}
+
+static inline uint32_t plain_json_intern_popcount64(uint64_t value) {
+    #ifdef __GNUC__
+    return (uint32_t)__builtin_popcountll(value);
+    #else
+    value = value - ((value >> 1) & 0x5555555555555555);
+    value = (value & 0x3333333333333333) + ((value >> 2) & 0x3333333333333333);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0F;
+    return (uint32_t)((value * 0x0101010101010101) >> 56);
+    #endif
+}
+
+/* Bit 'n' of the result is the xor of the bits 0 to 'n' */
+static inline uint64_t plain_json_intern_prefix_xor(uint64_t value) {
+    value ^= value << 1;
+    value ^= value << 2;
+    value ^= value << 4;
+    value ^= value << 8;
+    value ^= value << 16;
+    value ^= value << 32;
+    return value;
+}
+
+/* Find the characters escaped by a backslash: those following an odd length run of them.
+ * 'prev_escaped' carries an escape over into the next block. */
+static inline uint64_t plain_json_intern_find_escaped(uint64_t backslash, uint64_t *prev_escaped) {
+    static const uint64_t even_bits = 0x5555555555555555;
+
+    backslash &= ~(*prev_escaped);
+    const uint64_t follows_escape = backslash << 1 | (*prev_escaped);
+    const uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+    const uint64_t even_carries = backslash + odd_starts;
+    (*prev_escaped) = even_carries < backslash;
+
+    return (even_bits ^ (even_carries << 1)) & follows_escape;
+}
+
+static void plain_json_intern_classify_scalar(const uint8_t *block, plain_json_BlockMask *mask) {
+    plain_json_intern_memset(mask, 0, sizeof(*mask));
+
+    for (uint32_t i = 0; i < PLAIN_JSON_BLOCKSIZE; i++) {
+        const uint8_t c = block[i];
+        const uint64_t bit = (uint64_t)1 << i;
+
+        if (is_blank(c)) {
+            mask->blank |= bit;
+        } else if (c == '"') {
+            mask->quote |= bit;
+        } else if (c == '\\') {
+            mask->backslash |= bit;
+        } else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ',' || c == ':') {
+            mask->structural |= bit;
+        }
+
+        if (c < 0x20) {
+            mask->control |= bit;
+        }
+
+        if (c >= 0x80) {
+            mask->non_ascii |= bit;
+        }
+    }
+}
+
+    #ifdef PLAIN_JSON_SIMD_X86
+/* '{' and '[' (as well as '}' and ']') only differ in bit 0x20. */
+static void plain_json_intern_classify_sse2(const uint8_t *block, plain_json_BlockMask *mask) {
+    plain_json_intern_memset(mask, 0, sizeof(*mask));
+
+    for (uint32_t i = 0; i < PLAIN_JSON_BLOCKSIZE; i += 16) {
+        const __m128i chunk = _mm_loadu_si128((const __m128i *)(block + i));
+        const __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+
+        const __m128i blank = _mm_or_si128(
+            _mm_or_si128(
+                _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))
+            ),
+            _mm_or_si128(
+                _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))
+            )
+        );
+        const __m128i structural = _mm_or_si128(
+            _mm_or_si128(
+                _mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))
+            ),
+            _mm_or_si128(
+                _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(':'))
+            )
+        );
+        /* Unsigned 'chunk <= 0x1F' */
+        const __m128i control =
+            _mm_cmpeq_epi8(_mm_max_epu8(chunk, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F));
+
+        mask->blank |= (uint64_t)(uint16_t)_mm_movemask_epi8(blank) << i;
+        mask->quote |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')))
+                       << i;
+        mask->backslash |=
+            (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))) << i;
+        mask->control |= (uint64_t)(uint16_t)_mm_movemask_epi8(control) << i;
+        mask->structural |= (uint64_t)(uint16_t)_mm_movemask_epi8(structural) << i;
+        mask->non_ascii |= (uint64_t)(uint16_t)_mm_movemask_epi8(chunk) << i;
+    }
+}
+
+__attribute__((target("avx2"))) static void
+plain_json_intern_classify_avx2(const uint8_t *block, plain_json_BlockMask *mask) {
+    plain_json_intern_memset(mask, 0, sizeof(*mask));
+
+    for (uint32_t i = 0; i < PLAIN_JSON_BLOCKSIZE; i += 32) {
+        const __m256i chunk = _mm256_loadu_si256((const __m256i *)(block + i));
+        const __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+
+        const __m256i blank = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')),
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))
+            ),
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')),
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'))
+            )
+        );
+        const __m256i structural = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')),
+                _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'))
+            ),
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(',')),
+                _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':'))
+            )
+        );
+        const __m256i control =
+            _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, _mm256_set1_epi8(0x1F)), _mm256_set1_epi8(0x1F));
+
+        mask->blank |= (uint64_t)(uint32_t)_mm256_movemask_epi8(blank) << i;
+        mask->quote |=
+            (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')))
+            << i;
+        mask->backslash |=
+            (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\')))
+            << i;
+        mask->control |= (uint64_t)(uint32_t)_mm256_movemask_epi8(control) << i;
+        mask->structural |= (uint64_t)(uint32_t)_mm256_movemask_epi8(structural) << i;
+        mask->non_ascii |= (uint64_t)(uint32_t)_mm256_movemask_epi8(chunk) << i;
+    }
+}
+
+__attribute__((target("avx512f,avx512bw"))) static void
+plain_json_intern_classify_avx512(const uint8_t *block, plain_json_BlockMask *mask) {
+    const __m512i chunk = _mm512_loadu_si512((const void *)block);
+    const __m512i folded = _mm512_or_si512(chunk, _mm512_set1_epi8(0x20));
+
+    mask->blank = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(' ')) |
+                  _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\t')) |
+                  _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\n')) |
+                  _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\r'));
+    mask->quote = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('"'));
+    mask->backslash = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\\'));
+    mask->control = _mm512_cmple_epu8_mask(chunk, _mm512_set1_epi8(0x1F));
+    mask->structural = _mm512_cmpeq_epi8_mask(folded, _mm512_set1_epi8('{')) |
+                       _mm512_cmpeq_epi8_mask(folded, _mm512_set1_epi8('}')) |
+                       _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(',')) |
+                       _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(':'));
+    mask->non_ascii = _mm512_movepi8_mask(chunk);
+}
+    #endif
+
+/* Get the classification of the block starting at 'block_offset'. The last block of the buffer
+ * is padded with '\0', which (being a control character) never counts as blank. */
+static inline const plain_json_BlockMask *
+plain_json_intern_get_block(plain_json_Context *context, uintptr_t block_offset) {
+    json_assert(block_offset % PLAIN_JSON_BLOCKSIZE == 0);
+
+    if (context->block_offset == block_offset) {
+        return &context->block;
+    }
+
+    if (block_offset + PLAIN_JSON_BLOCKSIZE <= context->buffer_size) {
+        context->classify(context->buffer + block_offset, &context->block);
+    } else {
+        uint8_t padded[PLAIN_JSON_BLOCKSIZE] = { 0 };
+        plain_json_intern_memcpy(
+            padded, context->buffer + block_offset, context->buffer_size - block_offset
+        );
+        context->classify(padded, &context->block);
+    }
+
+    context->block_offset = block_offset;
+    return &context->block;
+}
+
+/* Jump to the next non blank character. Returns false if the end of the buffer was reached.
+ *
+ * The block masks are not turned into a list of structural offsets for the token reader to
+ * jump between. A structural character is a whole token and, after blanks, the next byte the
+ * reader looks at anyway. The bytes in between belong to strings, numbers and keywords, which
+ * their readers scan on their own (strings with the same masks). So the masks are only used to
+ * skip blank runs here, to scan strings, and in "plain_json_intern_count_tokens()". */
+static inline bool plain_json_intern_skip_blanks(plain_json_Context *context) {
+    const uint8_t *buffer = context->buffer;
+    const uintptr_t buffer_size = context->buffer_size;
+    uintptr_t offset = context->buffer_offset;
+
+    /* Compact documents have no or single blanks between tokens. The index is only
+     * worth it for longer runs (i.e. indentation). */
+    if (offset < buffer_size && is_blank(buffer[offset])) {
+        offset++;
+    }
+
+    while (offset < buffer_size && is_blank(buffer[offset])) {
+        const uintptr_t block_offset = offset - offset % PLAIN_JSON_BLOCKSIZE;
+        const plain_json_BlockMask *mask = plain_json_intern_get_block(context, block_offset);
+        const uint64_t remaining = ~mask->blank >> (offset - block_offset);
+
+        if (remaining != 0) {
+            offset += plain_json_intern_ctz64(remaining);
+            break;
+        }
+
+        offset = block_offset + PLAIN_JSON_BLOCKSIZE;
+    }
+
+    context->buffer_offset = offset < buffer_size ? offset : buffer_size;
+    return context->buffer_offset < buffer_size;
+}
+
+/* Estimate the buffer sizes required by the parser, block by block. Escaped quotes are found
+ * from the odd length backslash runs and the string bodies by xoring the remaining quotes.
+ * Outside of strings, each bracket and each run of scalar characters is a token, as is every
+ * string not followed by a ':' (i.e. not a key). Each string takes up at most its raw length
+ * plus its header and padding (or a header and reference), keys also take up their hash. The
+ * results are exact for valid documents, but meaningless otherwise. */
+static void plain_json_intern_count_tokens(
+    plain_json_Context *context, uintptr_t *token_count, uintptr_t *string_size
+) {
+    uint64_t prev_escaped = 0;
+    uint64_t prev_in_string = 0;
+    uint64_t prev_scalar = 0;
+    uintptr_t tokens = 0;
+    uintptr_t colons = 0;
+    uintptr_t strings = 0;
+    uintptr_t string_bytes = 0;
+
+    for (uintptr_t block_offset = 0; block_offset < context->buffer_size;
+         block_offset += PLAIN_JSON_BLOCKSIZE) {
+        const plain_json_BlockMask *mask = plain_json_intern_get_block(context, block_offset);
+        const uintptr_t remaining = context->buffer_size - block_offset;
+        const uint64_t valid =
+            remaining >= PLAIN_JSON_BLOCKSIZE ? ~(uint64_t)0 : ((uint64_t)1 << remaining) - 1;
+
+        const uint64_t escaped = plain_json_intern_find_escaped(mask->backslash, &prev_escaped);
+
+        /* The opening quote is part of the string, the closing one is not */
+        const uint64_t quote = mask->quote & ~escaped & valid;
+        const uint64_t in_string = plain_json_intern_prefix_xor(quote) ^ prev_in_string;
+        prev_in_string = (uint64_t)((int64_t)in_string >> 63);
+
+        strings += plain_json_intern_popcount64(quote & in_string);
+        string_bytes += plain_json_intern_popcount64(in_string & valid);
+
+        const uint64_t scalar = ~(mask->blank | mask->structural | quote | in_string) & valid;
+        tokens += plain_json_intern_popcount64(scalar & ~(scalar << 1 | prev_scalar));
+        prev_scalar = scalar >> 63;
+
+        uint64_t structural = mask->structural & ~in_string & valid;
+        while (structural != 0) {
+            const uint8_t c = context->buffer[block_offset + plain_json_intern_ctz64(structural)];
+            if (c == ':') {
+                colons++;
+            } else if (c != ',') {
+                tokens++;
+            }
+            structural &= structural - 1;
+        }
+    }
+
+    tokens += strings;
+    (*token_count) = tokens > colons ? tokens - colons : 0;
+    (*string_size) = string_bytes + strings * (3 + sizeof(uintptr_t)) + colons * sizeof(uint32_t);
+}
+
 /* Parsing */
 
-static inline plain_json_ErrorType plain_json_intern_read_utf8(
-    const uint8_t *buffer, uintptr_t buffer_size, uintptr_t *offset_ptr, uint8_t *cache,
-    uint32_t *cache_offset_ptr, plain_json_ErrorType *status
+static inline bool plain_json_intern_read_utf8(
+    const uint8_t *buffer, uintptr_t buffer_size, uintptr_t *offset_ptr, plain_json_ErrorType *status
 ) {
     static const uint32_t utf8_surrogate_mask = 0x0F200000;
     static const uint32_t utf8_surrogate_layout = 0x0D200000;
@@ -303,13 +1261,13 @@ static inline plain_json_ErrorType plain_json_intern_read_utf8(
     };
 
     uintptr_t offset = *offset_ptr;
-    uint32_t cache_offset = *cache_offset_ptr;
     uint8_t current_char = buffer[offset];
 
     uint8_t seq_length = length_table[current_char >> 4];
     uint32_t value = 0;
 
-    if (offset + seq_length >= buffer_size) {
+    /* The buffer only spans the strings content, a sequence may end on its last byte */
+    if (offset + seq_length > buffer_size) {
         (*status) = PLAIN_JSON_ERROR_STRING_UTF8_INVALID;
         return false;
     }
@@ -317,19 +1275,15 @@ static inline plain_json_ErrorType plain_json_intern_read_utf8(
     switch (seq_length) {
     case 4:
         value |= (uint32_t)buffer[offset + 3] & 0xff;
-        cache[cache_offset + 3] = buffer[offset + 3];
         /* fallthrough */
     case 3:
         value |= ((uint32_t)buffer[offset + 2] & 0xff) << 8;
-        cache[cache_offset + 2] = buffer[offset + 2];
         /* fallthrough */
     case 2:
         value |= ((uint32_t)buffer[offset + 1] & 0xff) << 16;
-        cache[cache_offset + 1] = buffer[offset + 1];
         /* fallthrough */
     case 1:
         value |= ((uint32_t)current_char & 0xff) << 24;
-        cache[cache_offset] = buffer[offset];
         break;
     default:
         /* unreachable */
@@ -343,7 +1297,7 @@ static inline plain_json_ErrorType plain_json_intern_read_utf8(
     }
 
     /* The surrogate range is not legal utf-8 */
-    if ((value & utf8_surrogate_mask) == utf8_surrogate_layout) {
+    if (seq_length == 3 && (value & utf8_surrogate_mask) == utf8_surrogate_layout) {
         (*status) = PLAIN_JSON_ERROR_STRING_UTF8_HAS_SURROGATE;
         return false;
     }
@@ -354,17 +1308,266 @@ static inline plain_json_ErrorType plain_json_intern_read_utf8(
     }
 
     (*offset_ptr) = offset + seq_length;
-    (*cache_offset_ptr) = cache_offset + seq_length;
 
     return true;
 }
 
+/* Validate a run of string content that does not contain any escapes, quotes or control
+ * characters. */
+static plain_json_ErrorType
+plain_json_intern_validate_utf8_scalar(const uint8_t *buffer, uintptr_t buffer_size) {
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    uintptr_t offset = 0;
+
+    while (offset < buffer_size) {
+        if (buffer[offset] < 0x80) {
+            offset++;
+            continue;
+        }
+
+        if (!plain_json_intern_read_utf8(buffer, buffer_size, &offset, &status)) {
+            return status;
+        }
+    }
+
+    return PLAIN_JSON_DONE;
+}
+
+    #ifdef PLAIN_JSON_SIMD_X86
+/* Vectorized validation with the lookup algorithm by Keiser and Lemire. Every byte is checked
+ * together with its predecessor: the high and low nibble of the previous byte and the high
+ * nibble of the current one each select a set of error bits, a sequence is only invalid if all
+ * three agree. Sequences of three and four bytes additionally require a continuation byte two
+ * and three positions after the header, which is checked with saturating subtractions.
+ *
+ * The vector code only tells whether a run is valid. Invalid runs are validated again with the
+ * scalar decoder, which keeps the exact error codes without slowing down the common case. */
+
+static const uint8_t plain_json_intern_utf8_byte_1_high[16] = {
+    /* 0___ ASCII followed by anything but ASCII or a header */
+    PLAIN_JSON_UTF8_TOO_LONG, PLAIN_JSON_UTF8_TOO_LONG, PLAIN_JSON_UTF8_TOO_LONG,
+    PLAIN_JSON_UTF8_TOO_LONG, PLAIN_JSON_UTF8_TOO_LONG, PLAIN_JSON_UTF8_TOO_LONG,
+    PLAIN_JSON_UTF8_TOO_LONG, PLAIN_JSON_UTF8_TOO_LONG,
+    /* 10__ continuation */
+    PLAIN_JSON_UTF8_TWO_CONTS, PLAIN_JSON_UTF8_TWO_CONTS, PLAIN_JSON_UTF8_TWO_CONTS,
+    PLAIN_JSON_UTF8_TWO_CONTS,
+    /* 1100 two byte header, 1100000_ is always overlong */
+    PLAIN_JSON_UTF8_TOO_SHORT | PLAIN_JSON_UTF8_OVERLONG_2,
+    /* 1101 */
+    PLAIN_JSON_UTF8_TOO_SHORT,
+    /* 1110 three byte header */
+    PLAIN_JSON_UTF8_TOO_SHORT | PLAIN_JSON_UTF8_OVERLONG_3 | PLAIN_JSON_UTF8_SURROGATE,
+    /* 1111 four byte header */
+    PLAIN_JSON_UTF8_TOO_SHORT | PLAIN_JSON_UTF8_TOO_LARGE | PLAIN_JSON_UTF8_TOO_LARGE_1000 |
+        PLAIN_JSON_UTF8_OVERLONG_4,
+};
+
+static const uint8_t plain_json_intern_utf8_byte_1_low[16] = {
+    /* ____0000 */
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_OVERLONG_2 | PLAIN_JSON_UTF8_OVERLONG_3 |
+        PLAIN_JSON_UTF8_OVERLONG_4,
+    /* ____0001 */
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_OVERLONG_2,
+    /* ____001_ */
+    PLAIN_JSON_UTF8_CARRY, PLAIN_JSON_UTF8_CARRY,
+    /* ____0100 */
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_TOO_LARGE,
+    /* ____0101 to ____1100 */
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_TOO_LARGE | PLAIN_JSON_UTF8_TOO_LARGE_1000,
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_TOO_LARGE | PLAIN_JSON_UTF8_TOO_LARGE_1000,
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_TOO_LARGE | PLAIN_JSON_UTF8_TOO_LARGE_1000,
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_TOO_LARGE | PLAIN_JSON_UTF8_TOO_LARGE_1000,
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_TOO_LARGE | PLAIN_JSON_UTF8_TOO_LARGE_1000,
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_TOO_LARGE | PLAIN_JSON_UTF8_TOO_LARGE_1000,
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_TOO_LARGE | PLAIN_JSON_UTF8_TOO_LARGE_1000,
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_TOO_LARGE | PLAIN_JSON_UTF8_TOO_LARGE_1000,
+    /* ____1101, 11101101 starts the surrogate range */
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_TOO_LARGE | PLAIN_JSON_UTF8_TOO_LARGE_1000 |
+        PLAIN_JSON_UTF8_SURROGATE,
+    /* ____111_ */
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_TOO_LARGE | PLAIN_JSON_UTF8_TOO_LARGE_1000,
+    PLAIN_JSON_UTF8_CARRY | PLAIN_JSON_UTF8_TOO_LARGE | PLAIN_JSON_UTF8_TOO_LARGE_1000,
+};
+
+static const uint8_t plain_json_intern_utf8_byte_2_high[16] = {
+    /* 0___ ASCII after a header */
+    PLAIN_JSON_UTF8_TOO_SHORT, PLAIN_JSON_UTF8_TOO_SHORT, PLAIN_JSON_UTF8_TOO_SHORT,
+    PLAIN_JSON_UTF8_TOO_SHORT, PLAIN_JSON_UTF8_TOO_SHORT, PLAIN_JSON_UTF8_TOO_SHORT,
+    PLAIN_JSON_UTF8_TOO_SHORT, PLAIN_JSON_UTF8_TOO_SHORT,
+    /* 1000 */
+    PLAIN_JSON_UTF8_TOO_LONG | PLAIN_JSON_UTF8_OVERLONG_2 | PLAIN_JSON_UTF8_TWO_CONTS |
+        PLAIN_JSON_UTF8_OVERLONG_3 | PLAIN_JSON_UTF8_TOO_LARGE_1000 | PLAIN_JSON_UTF8_OVERLONG_4,
+    /* 1001 */
+    PLAIN_JSON_UTF8_TOO_LONG | PLAIN_JSON_UTF8_OVERLONG_2 | PLAIN_JSON_UTF8_TWO_CONTS |
+        PLAIN_JSON_UTF8_OVERLONG_3 | PLAIN_JSON_UTF8_TOO_LARGE,
+    /* 101_ */
+    PLAIN_JSON_UTF8_TOO_LONG | PLAIN_JSON_UTF8_OVERLONG_2 | PLAIN_JSON_UTF8_TWO_CONTS |
+        PLAIN_JSON_UTF8_SURROGATE | PLAIN_JSON_UTF8_TOO_LARGE,
+    PLAIN_JSON_UTF8_TOO_LONG | PLAIN_JSON_UTF8_OVERLONG_2 | PLAIN_JSON_UTF8_TWO_CONTS |
+        PLAIN_JSON_UTF8_SURROGATE | PLAIN_JSON_UTF8_TOO_LARGE,
+    /* 11__ header after a header */
+    PLAIN_JSON_UTF8_TOO_SHORT, PLAIN_JSON_UTF8_TOO_SHORT, PLAIN_JSON_UTF8_TOO_SHORT,
+    PLAIN_JSON_UTF8_TOO_SHORT,
+};
+
+__attribute__((target("ssse3"))) static inline __m128i
+plain_json_intern_utf8_errors_ssse3(__m128i input, __m128i previous) {
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i prev1 = _mm_alignr_epi8(input, previous, 15);
+    const __m128i prev2 = _mm_alignr_epi8(input, previous, 14);
+    const __m128i prev3 = _mm_alignr_epi8(input, previous, 13);
+
+    const __m128i byte_1_high = _mm_shuffle_epi8(
+        _mm_loadu_si128((const __m128i *)plain_json_intern_utf8_byte_1_high),
+        _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)
+    );
+    const __m128i byte_1_low = _mm_shuffle_epi8(
+        _mm_loadu_si128((const __m128i *)plain_json_intern_utf8_byte_1_low),
+        _mm_and_si128(prev1, nibble)
+    );
+    const __m128i byte_2_high = _mm_shuffle_epi8(
+        _mm_loadu_si128((const __m128i *)plain_json_intern_utf8_byte_2_high),
+        _mm_and_si128(_mm_srli_epi16(input, 4), nibble)
+    );
+    const __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+    /* Only 111_____ (two bytes back) and 1111____ (three bytes back) end up >= 0x80 */
+    const __m128i must_be_continuation = _mm_and_si128(
+        _mm_or_si128(
+            _mm_subs_epu8(prev2, _mm_set1_epi8(0xE0 - 0x80)),
+            _mm_subs_epu8(prev3, _mm_set1_epi8(0xF0 - 0x80))
+        ),
+        _mm_set1_epi8((char)0x80)
+    );
+
+    return _mm_xor_si128(must_be_continuation, special);
+}
+
+__attribute__((target("ssse3"))) static plain_json_ErrorType
+plain_json_intern_validate_utf8_ssse3(const uint8_t *buffer, uintptr_t buffer_size) {
+    __m128i previous = _mm_setzero_si128();
+    __m128i error = _mm_setzero_si128();
+    uintptr_t offset = 0;
+
+    for (; offset + 16 <= buffer_size; offset += 16) {
+        const __m128i input = _mm_loadu_si128((const __m128i *)(buffer + offset));
+        error = _mm_or_si128(error, plain_json_intern_utf8_errors_ssse3(input, previous));
+        previous = input;
+    }
+
+    /* The zero padding behind the last byte catches sequences that are cut short */
+    uint8_t tail[16] = { 0 };
+    plain_json_intern_memcpy(tail, buffer + offset, buffer_size - offset);
+    error = _mm_or_si128(
+        error, plain_json_intern_utf8_errors_ssse3(_mm_loadu_si128((const __m128i *)tail), previous)
+    );
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF) {
+        return PLAIN_JSON_DONE;
+    }
+
+    return plain_json_intern_validate_utf8_scalar(buffer, buffer_size);
+}
+
+__attribute__((target("avx2"))) static inline __m256i
+plain_json_intern_utf8_errors_avx2(__m256i input, __m256i previous) {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    /* 'alignr' works on 128 bit lanes, the upper half of 'previous' is moved in front first */
+    const __m256i shifted = _mm256_permute2x128_si256(previous, input, 0x21);
+    const __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+    const __m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+    const __m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+
+    const __m256i byte_1_high = _mm256_shuffle_epi8(
+        _mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i *)plain_json_intern_utf8_byte_1_high)
+        ),
+        _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)
+    );
+    const __m256i byte_1_low = _mm256_shuffle_epi8(
+        _mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i *)plain_json_intern_utf8_byte_1_low)
+        ),
+        _mm256_and_si256(prev1, nibble)
+    );
+    const __m256i byte_2_high = _mm256_shuffle_epi8(
+        _mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i *)plain_json_intern_utf8_byte_2_high)
+        ),
+        _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)
+    );
+    const __m256i special =
+        _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    const __m256i must_be_continuation = _mm256_and_si256(
+        _mm256_or_si256(
+            _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xE0 - 0x80)),
+            _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xF0 - 0x80))
+        ),
+        _mm256_set1_epi8((char)0x80)
+    );
+
+    return _mm256_xor_si256(must_be_continuation, special);
+}
+
+__attribute__((target("avx2"))) static plain_json_ErrorType
+plain_json_intern_validate_utf8_avx2(const uint8_t *buffer, uintptr_t buffer_size) {
+    __m256i previous = _mm256_setzero_si256();
+    __m256i error = _mm256_setzero_si256();
+    uintptr_t offset = 0;
+
+    for (; offset + 32 <= buffer_size; offset += 32) {
+        const __m256i input = _mm256_loadu_si256((const __m256i *)(buffer + offset));
+        error = _mm256_or_si256(error, plain_json_intern_utf8_errors_avx2(input, previous));
+        previous = input;
+    }
+
+    uint8_t tail[32] = { 0 };
+    plain_json_intern_memcpy(tail, buffer + offset, buffer_size - offset);
+    error = _mm256_or_si256(
+        error,
+        plain_json_intern_utf8_errors_avx2(_mm256_loadu_si256((const __m256i *)tail), previous)
+    );
+
+    if (_mm256_testz_si256(error, error)) {
+        return PLAIN_JSON_DONE;
+    }
+
+    return plain_json_intern_validate_utf8_scalar(buffer, buffer_size);
+}
+    #endif
+
+static void plain_json_intern_select_simd(plain_json_Context *context) {
+    context->classify = plain_json_intern_classify_scalar;
+    context->validate_utf8 = plain_json_intern_validate_utf8_scalar;
+
+    #ifdef PLAIN_JSON_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) {
+        context->classify = plain_json_intern_classify_avx512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        context->classify = plain_json_intern_classify_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        context->classify = plain_json_intern_classify_sse2;
+    }
+
+    if (__builtin_cpu_supports("avx2")) {
+        context->validate_utf8 = plain_json_intern_validate_utf8_avx2;
+    } else if (__builtin_cpu_supports("ssse3")) {
+        context->validate_utf8 = plain_json_intern_validate_utf8_ssse3;
+    }
+    #endif
+}
+
 static inline bool
 plain_json_intern_encode_utf8(uint32_t codepoint, uint8_t *cache, uint32_t *cache_offset_ptr) {
     uint32_t cache_offset = *cache_offset_ptr;
     uint32_t part = 0;
 
-    if (codepoint <= 0x07FF) {
+    if (codepoint <= 0x007F) {
+        cache[cache_offset] = (uint8_t)codepoint;
+        cache_offset += 1;
+    } else if (codepoint <= 0x07FF) {
         part = codepoint;
         cache[cache_offset] = 0xC0 | ((part >> 6) & 0x1F);
         cache[cache_offset + 1] = 0x80 | (part & 0x3F);
@@ -430,28 +1633,28 @@ static inline plain_json_ErrorType plain_json_intern_read_escape(
     offset++;
     switch (current_char) {
     case '\\':
-        cache[cache_offset] = '\\';
+        cache[cache_offset++] = '\\';
         break;
     case '\"':
-        cache[cache_offset] = '"';
+        cache[cache_offset++] = '"';
         break;
     case '/':
-        cache[cache_offset] = '/';
+        cache[cache_offset++] = '/';
         break;
     case 'b':
-        cache[cache_offset] = '\b';
+        cache[cache_offset++] = '\b';
         break;
     case 'f':
-        cache[cache_offset] = '\f';
+        cache[cache_offset++] = '\f';
         break;
     case 'n':
-        cache[cache_offset] = '\n';
+        cache[cache_offset++] = '\n';
         break;
     case 'r':
-        cache[cache_offset] = '\r';
+        cache[cache_offset++] = '\r';
         break;
     case 't':
-        cache[cache_offset] = '\t';
+        cache[cache_offset++] = '\t';
         break;
     case 'u':;
         /* Parse UTF-16 */
@@ -518,41 +1721,287 @@ static inline plain_json_ErrorType plain_json_intern_read_escape(
     return PLAIN_JSON_DONE;
 }
 
-static plain_json_ErrorType plain_json_intern_read_string(plain_json_Context *context) {
-    const uint8_t *buffer = context->buffer + context->buffer_offset;
-    const uintptr_t buffer_size = context->buffer_size - context->buffer_offset;
+/* Find the next '"', '\\' or control character, starting at 'offset'. Sets 'has_utf8' if
+ * the skipped bytes contain any non ascii characters. */
+static inline uintptr_t
+plain_json_intern_find_string_special(plain_json_Context *context, uintptr_t offset, bool *has_utf8) {
+    while (offset < context->buffer_size) {
+        const uintptr_t block_offset = offset - offset % PLAIN_JSON_BLOCKSIZE;
+        const uint32_t shift = (uint32_t)(offset - block_offset);
+        const plain_json_BlockMask *mask = plain_json_intern_get_block(context, block_offset);
+
+        const uint64_t special = (mask->quote | mask->backslash | mask->control) >> shift;
+        const uint64_t non_ascii = mask->non_ascii >> shift;
+
+        if (special != 0) {
+            const uint32_t length = plain_json_intern_ctz64(special);
+            if ((non_ascii & (((uint64_t)1 << length) - 1)) != 0) {
+                (*has_utf8) = true;
+            }
 
-    uint8_t cache[PLAIN_JSON_STRING_CACHESIZE] = { 0 };
-    uint32_t cache_offset = 0;
+            offset += length;
+            break;
+        }
 
-    uintptr_t offset = 0;
-    uint8_t current_char = '\0';
+        if (non_ascii != 0) {
+            (*has_utf8) = true;
+        }
 
-    while (offset < buffer_size) {
-        current_char = buffer[offset];
+        offset = block_offset + PLAIN_JSON_BLOCKSIZE;
+    }
+
+    return offset < context->buffer_size ? offset : context->buffer_size;
+}
+
+/* Append a string entry that references 'length' bytes of the input at 'offset' */
+static inline bool plain_json_intern_append_reference(
+    plain_json_Context *context, uintptr_t offset, uintptr_t length
+) {
+    const uint32_t header = (uint32_t)length | PLAIN_JSON_STRING_REFERENCE;
+
+    return plain_json_intern_list_append(
+               &context->string_buffer, &context->alloc_config, &header, sizeof(header)
+           ) &&
+           plain_json_intern_list_append(
+               &context->string_buffer, &context->alloc_config, &offset, sizeof(offset)
+           );
+}
+
+/* Decode the string in place. The decoded string is never longer than its escaped form, so
+ * it is written back over itself and terminated with a NUL (at the latest, where the closing
+ * quote was). */
+static plain_json_ErrorType plain_json_intern_read_string_in_situ(plain_json_Context *context) {
+    uint8_t *buffer = (uint8_t *)context->buffer;
+    const uintptr_t buffer_size = context->buffer_size;
+    const uintptr_t start = context->buffer_offset;
+
+    uintptr_t offset = start;
+    uintptr_t write_offset = start;
+
+    while (true) {
+        bool has_utf8 = false;
+        const uintptr_t run_end = plain_json_intern_find_string_special(context, offset, &has_utf8);
+
+        if (run_end > offset) {
+            if (has_utf8) {
+                plain_json_ErrorType status =
+                    context->validate_utf8(buffer + offset, run_end - offset);
+                if (status != PLAIN_JSON_DONE) {
+                    return status;
+                }
+            }
+
+            if (write_offset != offset) {
+                plain_json_intern_move_down(buffer + write_offset, buffer + offset, run_end - offset);
+            }
+
+            write_offset += run_end - offset;
+            offset = run_end;
+        }
+
+        if (offset >= buffer_size) {
+            return PLAIN_JSON_ERROR_STRING_UNTERMINATED;
+        }
+
+        const uint8_t current_char = buffer[offset];
+        if (current_char == '\"') {
+            break;
+        }
+
+        if (current_char == '\\') {
+            if (offset + 1 >= buffer_size) {
+                return PLAIN_JSON_ERROR_STRING_UNTERMINATED;
+            }
+
+            uint8_t cache[4];
+            uint32_t cache_offset = 0;
+            plain_json_ErrorType status = PLAIN_JSON_DONE;
+            if (!plain_json_intern_read_escape(
+                    buffer, buffer_size, &offset, cache, &cache_offset, &status
+                )) {
+                return status;
+            }
+
+            plain_json_intern_memcpy(buffer + write_offset, cache, cache_offset);
+            write_offset += cache_offset;
+            continue;
+        }
+
+        if (current_char == '\0' || current_char == '\n') {
+            return PLAIN_JSON_ERROR_STRING_UNTERMINATED;
+        }
+
+        return PLAIN_JSON_ERROR_STRING_INVALID_ASCII;
+    }
+
+    buffer[write_offset] = '\0';
+    if (!plain_json_intern_append_reference(context, start, write_offset - start)) {
+        return PLAIN_JSON_ERROR_NO_MEMORY;
+    }
+
+    context->buffer_offset = offset + 1;
+    return PLAIN_JSON_HAS_REMAINING;
+}
+
+/* Validate a string without storing it, for values that a query does not select */
+static plain_json_ErrorType plain_json_intern_skip_string(plain_json_Context *context) {
+    const uint8_t *buffer = context->buffer;
+    const uintptr_t buffer_size = context->buffer_size;
+    uintptr_t offset = context->buffer_offset;
+
+    while (true) {
+        bool has_utf8 = false;
+        const uintptr_t run_end = plain_json_intern_find_string_special(context, offset, &has_utf8);
+
+        if (run_end > offset && has_utf8) {
+            plain_json_ErrorType status = context->validate_utf8(buffer + offset, run_end - offset);
+            if (status != PLAIN_JSON_DONE) {
+                return status;
+            }
+        }
+        offset = run_end;
+
+        if (offset >= buffer_size) {
+            return PLAIN_JSON_ERROR_STRING_UNTERMINATED;
+        }
+
+        const uint8_t current_char = buffer[offset];
+        if (current_char == '\"') {
+            break;
+        }
+
+        if (current_char == '\\') {
+            if (offset + 1 >= buffer_size) {
+                return PLAIN_JSON_ERROR_STRING_UNTERMINATED;
+            }
+
+            uint8_t cache[4];
+            uint32_t cache_offset = 0;
+            plain_json_ErrorType status = PLAIN_JSON_DONE;
+            if (!plain_json_intern_read_escape(
+                    buffer, buffer_size, &offset, cache, &cache_offset, &status
+                )) {
+                return status;
+            }
+            continue;
+        }
+
+        if (current_char == '\0' || current_char == '\n') {
+            return PLAIN_JSON_ERROR_STRING_UNTERMINATED;
+        }
+
+        return PLAIN_JSON_ERROR_STRING_INVALID_ASCII;
+    }
+
+    context->buffer_offset = offset + 1;
+    return PLAIN_JSON_HAS_REMAINING;
+}
+
+/* Strings are stored in the string buffer as a 4 byte header (the length) followed by the NUL
+ * terminated and padded contents. With PLAIN_JSON_FLAG_ZERO_COPY, strings without escapes
+ * are stored as a reference into the input instead: The header has the reference bit set and
+ * is followed by the strings offset, as are all strings parsed in situ. Entries are aligned to
+ * 4 bytes. */
+static plain_json_ErrorType plain_json_intern_read_string(plain_json_Context *context) {
+    static const uint8_t padding[4] = { 0 };
+
+    const uint8_t *buffer = context->buffer;
+    const uintptr_t buffer_size = context->buffer_size;
+    plain_json_List *string_buffer = &context->string_buffer;
+
+    /* Escapes are decoded into the cache, everything else is copied in bulk */
+    uint8_t cache[PLAIN_JSON_STRING_CACHESIZE];
+    uint32_t cache_offset = 0;
+
+    uintptr_t offset = context->buffer_offset;
+    uint32_t length = 0;
+
+    if (context->in_situ) {
+        return plain_json_intern_read_string_in_situ(context);
+    }
+
+    if (context->flags & PLAIN_JSON_FLAG_ZERO_COPY) {
+        bool has_utf8 = false;
+        const uintptr_t run_end = plain_json_intern_find_string_special(context, offset, &has_utf8);
+
+        if (run_end < buffer_size && buffer[run_end] == '\"') {
+            if (has_utf8) {
+                plain_json_ErrorType status =
+                    context->validate_utf8(buffer + offset, run_end - offset);
+                if (status != PLAIN_JSON_DONE) {
+                    return status;
+                }
+            }
 
-        /* Commit the cache and reserve 5 bytes for potential unicode characters + '\0' */
-        if (cache_offset + 5 >= PLAIN_JSON_STRING_CACHESIZE || current_char == '\"') {
-            if (!plain_json_intern_list_append(
-                    &context->string_buffer, &context->alloc_config, cache,
-                    cache_offset + (4 - cache_offset % 4)
+            if (!plain_json_intern_append_reference(context, offset, run_end - offset)) {
+                return PLAIN_JSON_ERROR_NO_MEMORY;
+            }
+
+            context->buffer_offset = run_end + 1;
+            return PLAIN_JSON_HAS_REMAINING;
+        }
+    }
+
+    /* The length is filled in once it is known */
+    const uint32_t header_index = string_buffer->item_count;
+    if (!plain_json_intern_list_append(string_buffer, &context->alloc_config, padding, 4)) {
+        return PLAIN_JSON_ERROR_NO_MEMORY;
+    }
+
+    while (true) {
+        bool has_utf8 = false;
+        const uintptr_t run_end = plain_json_intern_find_string_special(context, offset, &has_utf8);
+
+        if (run_end > offset) {
+            const uint32_t run_length = (uint32_t)(run_end - offset);
+
+            if (has_utf8) {
+                plain_json_ErrorType status = context->validate_utf8(buffer + offset, run_length);
+                if (status != PLAIN_JSON_DONE) {
+                    return status;
+                }
+            }
+
+            if ((cache_offset > 0 && !plain_json_intern_list_append(
+                                          string_buffer, &context->alloc_config, cache, cache_offset
+                                      )) ||
+                !plain_json_intern_list_append(
+                    string_buffer, &context->alloc_config, buffer + offset, run_length
                 )) {
                 return PLAIN_JSON_ERROR_NO_MEMORY;
             }
 
+            length += cache_offset + run_length;
             cache_offset = 0;
+            offset = run_end;
+        }
+
+        if (offset >= buffer_size) {
+            return PLAIN_JSON_ERROR_STRING_UNTERMINATED;
         }
 
+        const uint8_t current_char = buffer[offset];
         if (current_char == '\"') {
             break;
         }
 
-        /* Read escapes */
         if (current_char == '\\') {
             if (offset + 1 >= buffer_size) {
                 return PLAIN_JSON_ERROR_STRING_UNTERMINATED;
             }
 
+            /* Make room for the largest possible codepoint */
+            if (cache_offset + 4 > PLAIN_JSON_STRING_CACHESIZE) {
+                if (!plain_json_intern_list_append(
+                        string_buffer, &context->alloc_config, cache, cache_offset
+                    )) {
+                    return PLAIN_JSON_ERROR_NO_MEMORY;
+                }
+
+                length += cache_offset;
+                cache_offset = 0;
+            }
+
             plain_json_ErrorType status = PLAIN_JSON_DONE;
             if (!plain_json_intern_read_escape(
                     buffer, buffer_size, &offset, cache, &cache_offset, &status
@@ -567,32 +2016,394 @@ static plain_json_ErrorType plain_json_intern_read_string(plain_json_Context *co
             return PLAIN_JSON_ERROR_STRING_UNTERMINATED;
         }
 
-        if (current_char < 0x20) {
-            return PLAIN_JSON_ERROR_STRING_INVALID_ASCII;
-        }
+        return PLAIN_JSON_ERROR_STRING_INVALID_ASCII;
+    }
+
+    /* Terminate the string and keep the next entry 4 byte aligned */
+    length += cache_offset;
+    if ((cache_offset > 0 && !plain_json_intern_list_append(
+                                 string_buffer, &context->alloc_config, cache, cache_offset
+                             )) ||
+        !plain_json_intern_list_append(
+            string_buffer, &context->alloc_config, padding, 4 - length % 4
+        )) {
+        return PLAIN_JSON_ERROR_NO_MEMORY;
+    }
+
+    plain_json_intern_memcpy(string_buffer->buffer + header_index, &length, sizeof(length));
+
+    context->buffer_offset = offset + 1;
+    return PLAIN_JSON_HAS_REMAINING;
+}
+
+/* Decode the string entry at 'string_index' */
+static plain_json_String
+plain_json_intern_get_entry(plain_json_Context *context, uint32_t string_index) {
+    plain_json_String result = { PLAIN_JSON_NULL, 0 };
+
+    const uint8_t *entry = plain_json_list_get(&context->string_buffer, string_index);
+    if (entry == PLAIN_JSON_NULL) {
+        return result;
+    }
 
-        /* Read ASCII */
-        if (current_char < 0x80) {
-            cache[cache_offset] = current_char;
-            cache_offset += 1;
-            offset += 1;
+    uint32_t header = 0;
+    plain_json_intern_memcpy(&header, entry, sizeof(header));
+    result.length = header & ~(uint32_t)PLAIN_JSON_STRING_REFERENCE;
+    result.data = entry + sizeof(header);
+
+    if (header & PLAIN_JSON_STRING_REFERENCE) {
+        uintptr_t offset = 0;
+        plain_json_intern_memcpy(&offset, entry + sizeof(header), sizeof(offset));
+        result.data = context->buffer + offset;
+    }
+
+    return result;
+}
+
+/* Mixes in 8 bytes at a time with a multiply and xorshift, in the style of wyhash */
+static inline uint32_t plain_json_intern_hash(const uint8_t *data, uint32_t length) {
+    const uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+    uint64_t hash = multiplier ^ length;
+
+    uint32_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word = 0;
+        plain_json_intern_memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 32;
+    }
+
+    uint64_t tail = 0;
+    for (uint32_t shift = 0; i < length; i++, shift += 8) {
+        tail |= (uint64_t)data[i] << shift;
+    }
+    hash = (hash ^ tail) * multiplier;
+    hash ^= hash >> 29;
+
+    return (uint32_t)hash;
+}
+
+/* Keys are preceded by a 4 byte slot for their hash, filled in once the key was read */
+static inline uint32_t
+plain_json_intern_store_key_hash(plain_json_Context *context, uint32_t key_index) {
+    const plain_json_String key = plain_json_intern_get_entry(context, key_index);
+    const uint32_t hash = plain_json_intern_hash(key.data, key.length);
+
+    plain_json_intern_memcpy(
+        context->string_buffer.buffer + key_index - sizeof(hash), &hash, sizeof(hash)
+    );
+    return hash;
+}
+
+/* Double the size of the key table and reinsert all keys. Their hashes are kept in the table,
+ * so the keys themselves are not touched. */
+static bool plain_json_intern_grow_key_table(plain_json_Context *context) {
+    const uint32_t old_count = context->key_slot_count;
+    const uint32_t new_count = old_count != 0 ? old_count * 2 : PLAIN_JSON_KEY_TABLE_SIZE;
+    plain_json_AllocatorConfig *config = &context->alloc_config;
+
+    plain_json_KeySlot *slots = config->alloc_func(config->context, new_count * sizeof(*slots));
+    if (slots == PLAIN_JSON_NULL) {
+        return false;
+    }
+
+    plain_json_intern_memset(slots, 0xFF, new_count * sizeof(*slots));
+    for (uint32_t i = 0; i < old_count; i++) {
+        const plain_json_KeySlot slot = context->key_slots[i];
+        if (slot.key_index == PLAIN_JSON_NO_KEY) {
             continue;
         }
 
-        plain_json_ErrorType status = PLAIN_JSON_DONE;
-        if (!plain_json_intern_read_utf8(
-                buffer, buffer_size, &offset, cache, &cache_offset, &status
-            )) {
-            return status;
+        uint32_t position = slot.hash & (new_count - 1);
+        while (slots[position].key_index != PLAIN_JSON_NO_KEY) {
+            position = (position + 1) & (new_count - 1);
         }
+        slots[position] = slot;
     }
 
-    if (offset >= buffer_size) {
-        return PLAIN_JSON_ERROR_STRING_UNTERMINATED;
+    if (context->key_slots != PLAIN_JSON_NULL) {
+        config->free_func(config->context, context->key_slots);
     }
 
-    plain_json_intern_consume(context, offset + 1);
-    return PLAIN_JSON_HAS_REMAINING;
+    context->key_slots = slots;
+    context->key_slot_count = new_count;
+    return true;
+}
+
+/* Look up the key that was just read, which is the last entry of the string buffer. If the same
+ * key was seen before, the new entry is dropped and '*key_index' points to the existing one. */
+static bool
+plain_json_intern_dedup_key(plain_json_Context *context, uint32_t *key_index, uint32_t hash) {
+    /* Keep the load factor at or below 1/2 */
+    if ((context->key_count + 1) * 2 > context->key_slot_count &&
+        !plain_json_intern_grow_key_table(context)) {
+        return false;
+    }
+
+    const plain_json_String key = plain_json_intern_get_entry(context, *key_index);
+    const uint32_t mask = context->key_slot_count - 1;
+
+    uint32_t position = hash & mask;
+    while (context->key_slots[position].key_index != PLAIN_JSON_NO_KEY) {
+        const plain_json_KeySlot slot = context->key_slots[position];
+
+        if (slot.hash == hash) {
+            const plain_json_String other = plain_json_intern_get_entry(context, slot.key_index);
+            if (other.length == key.length &&
+                plain_json_intern_memcmp(other.data, key.data, key.length) == 0) {
+                context->string_buffer.item_count = *key_index - sizeof(hash);
+                (*key_index) = slot.key_index;
+                return true;
+            }
+        }
+
+        position = (position + 1) & mask;
+    }
+
+    context->key_slots[position].hash = hash;
+    context->key_slots[position].key_index = *key_index;
+    context->key_count++;
+    return true;
+}
+
+/* Forget the key that was interned last, before its entry is dropped from the string buffer.
+ * Nothing was inserted after it, so no other key was probed past its slot. */
+static void plain_json_intern_drop_key(plain_json_Context *context, uint32_t key_index) {
+    const uint32_t mask = context->key_slot_count - 1;
+
+    uint32_t position = plain_json_get_key_hash(context, key_index) & mask;
+    while (context->key_slots[position].key_index != key_index) {
+        position = (position + 1) & mask;
+    }
+
+    context->key_slots[position].key_index = PLAIN_JSON_NO_KEY;
+    context->key_count--;
+}
+
+static inline bool plain_json_intern_query_match(
+    plain_json_Context *context, const plain_json_QuerySegment *segment, uint32_t key_index,
+    uint32_t key_hash, uint32_t element_index
+) {
+    switch (segment->selector) {
+    case PLAIN_JSON_SELECTOR_WILDCARD:
+        return true;
+    case PLAIN_JSON_SELECTOR_NAME:
+        return key_index != PLAIN_JSON_NO_KEY && key_hash == segment->hash &&
+               plain_json_key_equals(
+                   context, key_index, context->query->names + segment->offset, segment->length
+               );
+    default:
+        return key_index == PLAIN_JSON_NO_KEY && element_index >= segment->start &&
+               element_index < segment->end &&
+               (element_index - segment->start) % segment->step == 0;
+    }
+}
+
+/* Decide whether the value that is about to be read is kept, given its key (in objects) or
+ * its position (in arrays). Only the segments matched by its parent are tried. */
+static void plain_json_intern_query_value(plain_json_Context *context, uint32_t key_index) {
+    const plain_json_Query *query = context->query;
+    const uint32_t level = context->depth;
+
+    if (context->query_emit_depth != 0 && level >= context->query_emit_depth) {
+        context->query_keep = true;
+        return;
+    }
+    if (context->query_dead_depth != 0 && level >= context->query_dead_depth) {
+        context->query_keep = false;
+        return;
+    }
+
+    /* The root is matched by "$" alone */
+    uint64_t positions = 1;
+    if (level > 0) {
+        plain_json_QueryLevel *parent =
+            (plain_json_QueryLevel *)plain_json_list_get(&context->query_levels, level - 1);
+        const uint32_t element_index = parent->element_index;
+        const uint32_t key_hash = key_index != PLAIN_JSON_NO_KEY
+                                      ? plain_json_get_key_hash(context, key_index)
+                                      : 0;
+        if (key_index == PLAIN_JSON_NO_KEY) {
+            parent->element_index++;
+        }
+
+        positions = 0;
+        for (uint64_t active = parent->positions; active != 0; active &= active - 1) {
+            const uint32_t position = plain_json_intern_ctz64(active);
+            const plain_json_QuerySegment *segment = &query->segments[position];
+
+            /* Descendant segments can still match further down */
+            if (segment->descendant) {
+                positions |= (uint64_t)1 << position;
+            }
+            if (plain_json_intern_query_match(
+                    context, segment, key_index, key_hash, element_index
+                )) {
+                positions |= (uint64_t)1 << (position + 1);
+            }
+        }
+    }
+
+    context->query_positions = positions;
+    context->query_keep = (positions >> query->segment_count) & 1;
+}
+
+/* Remember the matched segments of a container that was just opened, for its members or
+ * elements */
+static bool plain_json_intern_query_push(plain_json_Context *context) {
+    const uint32_t level = context->depth;
+    if (context->query_emit_depth != 0 || context->query_dead_depth != 0) {
+        return true;
+    }
+
+    if (context->query_keep) {
+        context->query_emit_depth = level;
+        return true;
+    }
+    if (context->query_positions == 0) {
+        context->query_dead_depth = level;
+        return true;
+    }
+
+    plain_json_List *levels = &context->query_levels;
+    const plain_json_QueryLevel entry = { context->query_positions, 0 };
+    if (level > levels->item_count) {
+        return plain_json_intern_list_append(levels, &context->alloc_config, &entry, 1);
+    }
+
+    plain_json_intern_memcpy(
+        levels->buffer + (uintptr_t)(level - 1) * levels->item_size, &entry, sizeof(entry)
+    );
+    return true;
+}
+
+/* Decide whether a token read with a query is kept. Closing a container ends the region that
+ * it started. */
+static inline bool plain_json_intern_query_keep(plain_json_Context *context, plain_json_Type type) {
+    if (type != PLAIN_JSON_TYPE_OBJECT_END && type != PLAIN_JSON_TYPE_ARRAY_END) {
+        return context->query_keep;
+    }
+
+    const uint32_t level = context->depth + 1;
+    const bool keep = context->query_emit_depth != 0 && level >= context->query_emit_depth;
+    if (level == context->query_emit_depth) {
+        context->query_emit_depth = 0;
+    }
+    if (level == context->query_dead_depth) {
+        context->query_dead_depth = 0;
+    }
+
+    return keep;
+}
+
+static inline void plain_json_intern_clear_members(plain_json_Context *context) {
+    if (context->member_count > 0) {
+        plain_json_intern_memset(
+            context->member_slots, 0xFF, context->member_slot_count * sizeof(*context->member_slots)
+        );
+        context->member_count = 0;
+    }
+}
+
+/* Open a container. The inline words are copied into "depth_spill" once they run out, which
+ * grows by doubling after that. */
+static inline bool plain_json_intern_push_depth(plain_json_Context *context, bool is_object) {
+    const uint32_t word = context->depth / 64;
+    const uint64_t bit = (uint64_t)1 << (context->depth % 64);
+
+    uint64_t *words = context->depth_spill;
+    if (words == PLAIN_JSON_NULL) {
+        words = context->depth_inline;
+    }
+
+    if (word >= PLAIN_JSON_DEPTH_INLINE && word >= context->depth_capacity) {
+        plain_json_AllocatorConfig *config = &context->alloc_config;
+        const uint32_t old_count = context->depth_capacity;
+        const uint32_t new_count = old_count != 0 ? old_count * 2 : PLAIN_JSON_DEPTH_INLINE * 4;
+
+        if (old_count == 0) {
+            words = config->alloc_func(config->context, new_count * sizeof(*words));
+            if (words != PLAIN_JSON_NULL) {
+                for (uint32_t i = 0; i < PLAIN_JSON_DEPTH_INLINE; i++) {
+                    words[i] = context->depth_inline[i];
+                }
+            }
+        } else {
+            words = config->realloc_func(
+                config->context, words, old_count * sizeof(*words), new_count * sizeof(*words)
+            );
+        }
+
+        if (words == PLAIN_JSON_NULL) {
+            return false;
+        }
+
+        context->depth_spill = words;
+        context->depth_capacity = new_count;
+    }
+
+    words[word] = is_object ? (words[word] | bit) : (words[word] & ~bit);
+    context->depth++;
+    return true;
+}
+
+/* Close the innermost container and return the state that follows it in the parent */
+static inline uint8_t plain_json_intern_pop_depth(plain_json_Context *context) {
+    context->depth--;
+    if (context->depth == 0) {
+        return PLAIN_JSON_STATE_ROOT_END;
+    }
+
+    const uint32_t parent = context->depth - 1;
+    const uint64_t *words = context->depth_spill;
+    if (words == PLAIN_JSON_NULL) {
+        words = context->depth_inline;
+    }
+
+    return (words[parent / 64] >> (parent % 64)) & 1 ? PLAIN_JSON_STATE_OBJECT_COMMA
+                                                     : PLAIN_JSON_STATE_ARRAY_COMMA;
+}
+
+/* Find the node of the key that was just read, among the children of the innermost objects
+ * node. Returns PLAIN_JSON_NO_KEY if the mask does not select the member. */
+static inline uint32_t
+plain_json_intern_mask_member(plain_json_Context *context, uint32_t key_index, uint32_t key_hash) {
+    const plain_json_Mask *mask = context->mask;
+    const plain_json_MaskNode *parent = &mask->nodes[context->mask_node];
+    if (parent->keep_all) {
+        return context->mask_node;
+    }
+
+    uint32_t child = parent->first_child;
+    while (child != PLAIN_JSON_NO_KEY) {
+        const plain_json_MaskNode *node = &mask->nodes[child];
+        if (node->hash == key_hash &&
+            plain_json_key_equals(context, key_index, mask->names + node->offset, node->length)) {
+            break;
+        }
+        child = node->next_sibling;
+    }
+
+    return child;
+}
+
+/* Enter the node of the container that was just opened */
+static bool plain_json_intern_mask_push(plain_json_Context *context) {
+    const uint32_t level = context->depth;
+    plain_json_List *levels = &context->mask_levels;
+
+    context->mask_node = context->mask_value;
+    if (level > levels->item_count) {
+        return plain_json_intern_list_append(
+            levels, &context->alloc_config, &context->mask_node, 1
+        );
+    }
+
+    plain_json_intern_memcpy(
+        levels->buffer + (uintptr_t)(level - 1) * levels->item_size, &context->mask_node,
+        sizeof(context->mask_node)
+    );
+    return true;
 }
 
 static inline plain_json_ErrorType
@@ -617,468 +2428,3097 @@ plain_json_intern_read_keyword(plain_json_Context *context, plain_json_Token *to
             token->length = 4;
             return PLAIN_JSON_HAS_REMAINING;
         }
-        break;
-    case 'f':
-        if (buffer_size > 4 && buffer[1] == 'a' && buffer[2] == 'l' && buffer[3] == 's' &&
-            buffer[4] == 'e') {
-            plain_json_intern_consume(context, 5);
-            token->type = PLAIN_JSON_TYPE_FALSE;
-            token->length = 5;
-            return PLAIN_JSON_HAS_REMAINING;
+        break;
+    case 'f':
+        if (buffer_size > 4 && buffer[1] == 'a' && buffer[2] == 'l' && buffer[3] == 's' &&
+            buffer[4] == 'e') {
+            plain_json_intern_consume(context, 5);
+            token->type = PLAIN_JSON_TYPE_FALSE;
+            token->length = 5;
+            return PLAIN_JSON_HAS_REMAINING;
+        }
+        break;
+    }
+
+    return PLAIN_JSON_ERROR_KEYWORD_INVALID;
+}
+
+/* Floating point conversion
+ *
+ * A decimal number 'w * 10^q' is converted in up to three steps:
+ * - Clinger's fast path, if both 'w' and '10^q' are exactly representable.
+ * - The Eisel-Lemire algorithm, which multiplies 'w' by a truncated 128 bit '5^q' and is always
+ *   correct for a 'w' of up to 19 digits.
+ * - If the significand had more digits and the result of the truncated 'w' and 'w + 1' differs,
+ *   the number is converted from its full decimal representation by repeated shifting. */
+
+/// Parameters of an IEEE 754 binary format.
+typedef struct {
+    uint32_t mantissa_bits;
+    int32_t minimum_exponent;
+    int32_t infinite_power;
+    int32_t smallest_power_of_ten;
+    int32_t largest_power_of_ten;
+    int32_t min_exponent_round_to_even;
+    int32_t max_exponent_round_to_even;
+} plain_json_FloatFormat;
+
+/// The explicit mantissa bits and the biased exponent of a float.
+typedef struct {
+    uint64_t mantissa;
+    int32_t power2;
+} plain_json_FloatBits;
+
+/// Decimal representation used by the slow path. The value is '0.d[0]d[1]... * 10^point'.
+/// The additional space is used as scratch space when shifting left.
+typedef struct {
+    uint8_t digits[PLAIN_JSON_DECIMAL_DIGITS + 16];
+    int32_t count;
+    int32_t point;
+    bool is_truncated;
+} plain_json_Decimal;
+
+static const plain_json_FloatFormat plain_json_intern_float64_format = {
+    52, -1023, 0x7FF, -342, 308, -4, 23,
+};
+
+static const plain_json_FloatFormat plain_json_intern_float32_format = {
+    23, -127, 0xFF, -64, 38, -17, 10,
+};
+
+/* 128 bit approximations of 5^q for q in [-342, 308], with the most significant bit set. Each
+ * entry consists of the upper and the lower 64 bits. */
+static const uint64_t plain_json_intern_power_of_five[] = {
+    0xEEF453D6923BD65A, 0x113FAA2906A13B3F,
+    0x9558B4661B6565F8, 0x4AC7CA59A424C507,
+    0xBAAEE17FA23EBF76, 0x5D79BCF00D2DF649,
+    0xE95A99DF8ACE6F53, 0xF4D82C2C107973DC,
+    0x91D8A02BB6C10594, 0x79071B9B8A4BE869,
+    0xB64EC836A47146F9, 0x9748E2826CDEE284,
+    0xE3E27A444D8D98B7, 0xFD1B1B2308169B25,
+    0x8E6D8C6AB0787F72, 0xFE30F0F5E50E20F7,
+    0xB208EF855C969F4F, 0xBDBD2D335E51A935,
+    0xDE8B2B66B3BC4723, 0xAD2C788035E61382,
+    0x8B16FB203055AC76, 0x4C3BCB5021AFCC31,
+    0xADDCB9E83C6B1793, 0xDF4ABE242A1BBF3D,
+    0xD953E8624B85DD78, 0xD71D6DAD34A2AF0D,
+    0x87D4713D6F33AA6B, 0x8672648C40E5AD68,
+    0xA9C98D8CCB009506, 0x680EFDAF511F18C2,
+    0xD43BF0EFFDC0BA48, 0x0212BD1B2566DEF2,
+    0x84A57695FE98746D, 0x014BB630F7604B57,
+    0xA5CED43B7E3E9188, 0x419EA3BD35385E2D,
+    0xCF42894A5DCE35EA, 0x52064CAC828675B9,
+    0x818995CE7AA0E1B2, 0x7343EFEBD1940993,
+    0xA1EBFB4219491A1F, 0x1014EBE6C5F90BF8,
+    0xCA66FA129F9B60A6, 0xD41A26E077774EF6,
+    0xFD00B897478238D0, 0x8920B098955522B4,
+    0x9E20735E8CB16382, 0x55B46E5F5D5535B0,
+    0xC5A890362FDDBC62, 0xEB2189F734AA831D,
+    0xF712B443BBD52B7B, 0xA5E9EC7501D523E4,
+    0x9A6BB0AA55653B2D, 0x47B233C92125366E,
+    0xC1069CD4EABE89F8, 0x999EC0BB696E840A,
+    0xF148440A256E2C76, 0xC00670EA43CA250D,
+    0x96CD2A865764DBCA, 0x380406926A5E5728,
+    0xBC807527ED3E12BC, 0xC605083704F5ECF2,
+    0xEBA09271E88D976B, 0xF7864A44C633682E,
+    0x93445B8731587EA3, 0x7AB3EE6AFBE0211D,
+    0xB8157268FDAE9E4C, 0x5960EA05BAD82964,
+    0xE61ACF033D1A45DF, 0x6FB92487298E33BD,
+    0x8FD0C16206306BAB, 0xA5D3B6D479F8E056,
+    0xB3C4F1BA87BC8696, 0x8F48A4899877186C,
+    0xE0B62E2929ABA83C, 0x331ACDABFE94DE87,
+    0x8C71DCD9BA0B4925, 0x9FF0C08B7F1D0B14,
+    0xAF8E5410288E1B6F, 0x07ECF0AE5EE44DD9,
+    0xDB71E91432B1A24A, 0xC9E82CD9F69D6150,
+    0x892731AC9FAF056E, 0xBE311C083A225CD2,
+    0xAB70FE17C79AC6CA, 0x6DBD630A48AAF406,
+    0xD64D3D9DB981787D, 0x092CBBCCDAD5B108,
+    0x85F0468293F0EB4E, 0x25BBF56008C58EA5,
+    0xA76C582338ED2621, 0xAF2AF2B80AF6F24E,
+    0xD1476E2C07286FAA, 0x1AF5AF660DB4AEE1,
+    0x82CCA4DB847945CA, 0x50D98D9FC890ED4D,
+    0xA37FCE126597973C, 0xE50FF107BAB528A0,
+    0xCC5FC196FEFD7D0C, 0x1E53ED49A96272C8,
+    0xFF77B1FCBEBCDC4F, 0x25E8E89C13BB0F7A,
+    0x9FAACF3DF73609B1, 0x77B191618C54E9AC,
+    0xC795830D75038C1D, 0xD59DF5B9EF6A2417,
+    0xF97AE3D0D2446F25, 0x4B0573286B44AD1D,
+    0x9BECCE62836AC577, 0x4EE367F9430AEC32,
+    0xC2E801FB244576D5, 0x229C41F793CDA73F,
+    0xF3A20279ED56D48A, 0x6B43527578C1110F,
+    0x9845418C345644D6, 0x830A13896B78AAA9,
+    0xBE5691EF416BD60C, 0x23CC986BC656D553,
+    0xEDEC366B11C6CB8F, 0x2CBFBE86B7EC8AA8,
+    0x94B3A202EB1C3F39, 0x7BF7D71432F3D6A9,
+    0xB9E08A83A5E34F07, 0xDAF5CCD93FB0CC53,
+    0xE858AD248F5C22C9, 0xD1B3400F8F9CFF68,
+    0x91376C36D99995BE, 0x23100809B9C21FA1,
+    0xB58547448FFFFB2D, 0xABD40A0C2832A78A,
+    0xE2E69915B3FFF9F9, 0x16C90C8F323F516C,
+    0x8DD01FAD907FFC3B, 0xAE3DA7D97F6792E3,
+    0xB1442798F49FFB4A, 0x99CD11CFDF41779C,
+    0xDD95317F31C7FA1D, 0x40405643D711D583,
+    0x8A7D3EEF7F1CFC52, 0x482835EA666B2572,
+    0xAD1C8EAB5EE43B66, 0xDA3243650005EECF,
+    0xD863B256369D4A40, 0x90BED43E40076A82,
+    0x873E4F75E2224E68, 0x5A7744A6E804A291,
+    0xA90DE3535AAAE202, 0x711515D0A205CB36,
+    0xD3515C2831559A83, 0x0D5A5B44CA873E03,
+    0x8412D9991ED58091, 0xE858790AFE9486C2,
+    0xA5178FFF668AE0B6, 0x626E974DBE39A872,
+    0xCE5D73FF402D98E3, 0xFB0A3D212DC8128F,
+    0x80FA687F881C7F8E, 0x7CE66634BC9D0B99,
+    0xA139029F6A239F72, 0x1C1FFFC1EBC44E80,
+    0xC987434744AC874E, 0xA327FFB266B56220,
+    0xFBE9141915D7A922, 0x4BF1FF9F0062BAA8,
+    0x9D71AC8FADA6C9B5, 0x6F773FC3603DB4A9,
+    0xC4CE17B399107C22, 0xCB550FB4384D21D3,
+    0xF6019DA07F549B2B, 0x7E2A53A146606A48,
+    0x99C102844F94E0FB, 0x2EDA7444CBFC426D,
+    0xC0314325637A1939, 0xFA911155FEFB5308,
+    0xF03D93EEBC589F88, 0x793555AB7EBA27CA,
+    0x96267C7535B763B5, 0x4BC1558B2F3458DE,
+    0xBBB01B9283253CA2, 0x9EB1AAEDFB016F16,
+    0xEA9C227723EE8BCB, 0x465E15A979C1CADC,
+    0x92A1958A7675175F, 0x0BFACD89EC191EC9,
+    0xB749FAED14125D36, 0xCEF980EC671F667B,
+    0xE51C79A85916F484, 0x82B7E12780E7401A,
+    0x8F31CC0937AE58D2, 0xD1B2ECB8B0908810,
+    0xB2FE3F0B8599EF07, 0x861FA7E6DCB4AA15,
+    0xDFBDCECE67006AC9, 0x67A791E093E1D49A,
+    0x8BD6A141006042BD, 0xE0C8BB2C5C6D24E0,
+    0xAECC49914078536D, 0x58FAE9F773886E18,
+    0xDA7F5BF590966848, 0xAF39A475506A899E,
+    0x888F99797A5E012D, 0x6D8406C952429603,
+    0xAAB37FD7D8F58178, 0xC8E5087BA6D33B83,
+    0xD5605FCDCF32E1D6, 0xFB1E4A9A90880A64,
+    0x855C3BE0A17FCD26, 0x5CF2EEA09A55067F,
+    0xA6B34AD8C9DFC06F, 0xF42FAA48C0EA481E,
+    0xD0601D8EFC57B08B, 0xF13B94DAF124DA26,
+    0x823C12795DB6CE57, 0x76C53D08D6B70858,
+    0xA2CB1717B52481ED, 0x54768C4B0C64CA6E,
+    0xCB7DDCDDA26DA268, 0xA9942F5DCF7DFD09,
+    0xFE5D54150B090B02, 0xD3F93B35435D7C4C,
+    0x9EFA548D26E5A6E1, 0xC47BC5014A1A6DAF,
+    0xC6B8E9B0709F109A, 0x359AB6419CA1091B,
+    0xF867241C8CC6D4C0, 0xC30163D203C94B62,
+    0x9B407691D7FC44F8, 0x79E0DE63425DCF1D,
+    0xC21094364DFB5636, 0x985915FC12F542E4,
+    0xF294B943E17A2BC4, 0x3E6F5B7B17B2939D,
+    0x979CF3CA6CEC5B5A, 0xA705992CEECF9C42,
+    0xBD8430BD08277231, 0x50C6FF782A838353,
+    0xECE53CEC4A314EBD, 0xA4F8BF5635246428,
+    0x940F4613AE5ED136, 0x871B7795E136BE99,
+    0xB913179899F68584, 0x28E2557B59846E3F,
+    0xE757DD7EC07426E5, 0x331AEADA2FE589CF,
+    0x9096EA6F3848984F, 0x3FF0D2C85DEF7621,
+    0xB4BCA50B065ABE63, 0x0FED077A756B53A9,
+    0xE1EBCE4DC7F16DFB, 0xD3E8495912C62894,
+    0x8D3360F09CF6E4BD, 0x64712DD7ABBBD95C,
+    0xB080392CC4349DEC, 0xBD8D794D96AACFB3,
+    0xDCA04777F541C567, 0xECF0D7A0FC5583A0,
+    0x89E42CAAF9491B60, 0xF41686C49DB57244,
+    0xAC5D37D5B79B6239, 0x311C2875C522CED5,
+    0xD77485CB25823AC7, 0x7D633293366B828B,
+    0x86A8D39EF77164BC, 0xAE5DFF9C02033197,
+    0xA8530886B54DBDEB, 0xD9F57F830283FDFC,
+    0xD267CAA862A12D66, 0xD072DF63C324FD7B,
+    0x8380DEA93DA4BC60, 0x4247CB9E59F71E6D,
+    0xA46116538D0DEB78, 0x52D9BE85F074E608,
+    0xCD795BE870516656, 0x67902E276C921F8B,
+    0x806BD9714632DFF6, 0x00BA1CD8A3DB53B6,
+    0xA086CFCD97BF97F3, 0x80E8A40ECCD228A4,
+    0xC8A883C0FDAF7DF0, 0x6122CD128006B2CD,
+    0xFAD2A4B13D1B5D6C, 0x796B805720085F81,
+    0x9CC3A6EEC6311A63, 0xCBE3303674053BB0,
+    0xC3F490AA77BD60FC, 0xBEDBFC4411068A9C,
+    0xF4F1B4D515ACB93B, 0xEE92FB5515482D44,
+    0x991711052D8BF3C5, 0x751BDD152D4D1C4A,
+    0xBF5CD54678EEF0B6, 0xD262D45A78A0635D,
+    0xEF340A98172AACE4, 0x86FB897116C87C34,
+    0x9580869F0E7AAC0E, 0xD45D35E6AE3D4DA0,
+    0xBAE0A846D2195712, 0x8974836059CCA109,
+    0xE998D258869FACD7, 0x2BD1A438703FC94B,
+    0x91FF83775423CC06, 0x7B6306A34627DDCF,
+    0xB67F6455292CBF08, 0x1A3BC84C17B1D542,
+    0xE41F3D6A7377EECA, 0x20CABA5F1D9E4A93,
+    0x8E938662882AF53E, 0x547EB47B7282EE9C,
+    0xB23867FB2A35B28D, 0xE99E619A4F23AA43,
+    0xDEC681F9F4C31F31, 0x6405FA00E2EC94D4,
+    0x8B3C113C38F9F37E, 0xDE83BC408DD3DD04,
+    0xAE0B158B4738705E, 0x9624AB50B148D445,
+    0xD98DDAEE19068C76, 0x3BADD624DD9B0957,
+    0x87F8A8D4CFA417C9, 0xE54CA5D70A80E5D6,
+    0xA9F6D30A038D1DBC, 0x5E9FCF4CCD211F4C,
+    0xD47487CC8470652B, 0x7647C3200069671F,
+    0x84C8D4DFD2C63F3B, 0x29ECD9F40041E073,
+    0xA5FB0A17C777CF09, 0xF468107100525890,
+    0xCF79CC9DB955C2CC, 0x7182148D4066EEB4,
+    0x81AC1FE293D599BF, 0xC6F14CD848405530,
+    0xA21727DB38CB002F, 0xB8ADA00E5A506A7C,
+    0xCA9CF1D206FDC03B, 0xA6D90811F0E4851C,
+    0xFD442E4688BD304A, 0x908F4A166D1DA663,
+    0x9E4A9CEC15763E2E, 0x9A598E4E043287FE,
+    0xC5DD44271AD3CDBA, 0x40EFF1E1853F29FD,
+    0xF7549530E188C128, 0xD12BEE59E68EF47C,
+    0x9A94DD3E8CF578B9, 0x82BB74F8301958CE,
+    0xC13A148E3032D6E7, 0xE36A52363C1FAF01,
+    0xF18899B1BC3F8CA1, 0xDC44E6C3CB279AC1,
+    0x96F5600F15A7B7E5, 0x29AB103A5EF8C0B9,
+    0xBCB2B812DB11A5DE, 0x7415D448F6B6F0E7,
+    0xEBDF661791D60F56, 0x111B495B3464AD21,
+    0x936B9FCEBB25C995, 0xCAB10DD900BEEC34,
+    0xB84687C269EF3BFB, 0x3D5D514F40EEA742,
+    0xE65829B3046B0AFA, 0x0CB4A5A3112A5112,
+    0x8FF71A0FE2C2E6DC, 0x47F0E785EABA72AB,
+    0xB3F4E093DB73A093, 0x59ED216765690F56,
+    0xE0F218B8D25088B8, 0x306869C13EC3532C,
+    0x8C974F7383725573, 0x1E414218C73A13FB,
+    0xAFBD2350644EEACF, 0xE5D1929EF90898FA,
+    0xDBAC6C247D62A583, 0xDF45F746B74ABF39,
+    0x894BC396CE5DA772, 0x6B8BBA8C328EB783,
+    0xAB9EB47C81F5114F, 0x066EA92F3F326564,
+    0xD686619BA27255A2, 0xC80A537B0EFEFEBD,
+    0x8613FD0145877585, 0xBD06742CE95F5F36,
+    0xA798FC4196E952E7, 0x2C48113823B73704,
+    0xD17F3B51FCA3A7A0, 0xF75A15862CA504C5,
+    0x82EF85133DE648C4, 0x9A984D73DBE722FB,
+    0xA3AB66580D5FDAF5, 0xC13E60D0D2E0EBBA,
+    0xCC963FEE10B7D1B3, 0x318DF905079926A8,
+    0xFFBBCFE994E5C61F, 0xFDF17746497F7052,
+    0x9FD561F1FD0F9BD3, 0xFEB6EA8BEDEFA633,
+    0xC7CABA6E7C5382C8, 0xFE64A52EE96B8FC0,
+    0xF9BD690A1B68637B, 0x3DFDCE7AA3C673B0,
+    0x9C1661A651213E2D, 0x06BEA10CA65C084E,
+    0xC31BFA0FE5698DB8, 0x486E494FCFF30A62,
+    0xF3E2F893DEC3F126, 0x5A89DBA3C3EFCCFA,
+    0x986DDB5C6B3A76B7, 0xF89629465A75E01C,
+    0xBE89523386091465, 0xF6BBB397F1135823,
+    0xEE2BA6C0678B597F, 0x746AA07DED582E2C,
+    0x94DB483840B717EF, 0xA8C2A44EB4571CDC,
+    0xBA121A4650E4DDEB, 0x92F34D62616CE413,
+    0xE896A0D7E51E1566, 0x77B020BAF9C81D17,
+    0x915E2486EF32CD60, 0x0ACE1474DC1D122E,
+    0xB5B5ADA8AAFF80B8, 0x0D819992132456BA,
+    0xE3231912D5BF60E6, 0x10E1FFF697ED6C69,
+    0x8DF5EFABC5979C8F, 0xCA8D3FFA1EF463C1,
+    0xB1736B96B6FD83B3, 0xBD308FF8A6B17CB2,
+    0xDDD0467C64BCE4A0, 0xAC7CB3F6D05DDBDE,
+    0x8AA22C0DBEF60EE4, 0x6BCDF07A423AA96B,
+    0xAD4AB7112EB3929D, 0x86C16C98D2C953C6,
+    0xD89D64D57A607744, 0xE871C7BF077BA8B7,
+    0x87625F056C7C4A8B, 0x11471CD764AD4972,
+    0xA93AF6C6C79B5D2D, 0xD598E40D3DD89BCF,
+    0xD389B47879823479, 0x4AFF1D108D4EC2C3,
+    0x843610CB4BF160CB, 0xCEDF722A585139BA,
+    0xA54394FE1EEDB8FE, 0xC2974EB4EE658828,
+    0xCE947A3DA6A9273E, 0x733D226229FEEA32,
+    0x811CCC668829B887, 0x0806357D5A3F525F,
+    0xA163FF802A3426A8, 0xCA07C2DCB0CF26F7,
+    0xC9BCFF6034C13052, 0xFC89B393DD02F0B5,
+    0xFC2C3F3841F17C67, 0xBBAC2078D443ACE2,
+    0x9D9BA7832936EDC0, 0xD54B944B84AA4C0D,
+    0xC5029163F384A931, 0x0A9E795E65D4DF11,
+    0xF64335BCF065D37D, 0x4D4617B5FF4A16D5,
+    0x99EA0196163FA42E, 0x504BCED1BF8E4E45,
+    0xC06481FB9BCF8D39, 0xE45EC2862F71E1D6,
+    0xF07DA27A82C37088, 0x5D767327BB4E5A4C,
+    0x964E858C91BA2655, 0x3A6A07F8D510F86F,
+    0xBBE226EFB628AFEA, 0x890489F70A55368B,
+    0xEADAB0ABA3B2DBE5, 0x2B45AC74CCEA842E,
+    0x92C8AE6B464FC96F, 0x3B0B8BC90012929D,
+    0xB77ADA0617E3BBCB, 0x09CE6EBB40173744,
+    0xE55990879DDCAABD, 0xCC420A6A101D0515,
+    0x8F57FA54C2A9EAB6, 0x9FA946824A12232D,
+    0xB32DF8E9F3546564, 0x47939822DC96ABF9,
+    0xDFF9772470297EBD, 0x59787E2B93BC56F7,
+    0x8BFBEA76C619EF36, 0x57EB4EDB3C55B65A,
+    0xAEFAE51477A06B03, 0xEDE622920B6B23F1,
+    0xDAB99E59958885C4, 0xE95FAB368E45ECED,
+    0x88B402F7FD75539B, 0x11DBCB0218EBB414,
+    0xAAE103B5FCD2A881, 0xD652BDC29F26A119,
+    0xD59944A37C0752A2, 0x4BE76D3346F0495F,
+    0x857FCAE62D8493A5, 0x6F70A4400C562DDB,
+    0xA6DFBD9FB8E5B88E, 0xCB4CCD500F6BB952,
+    0xD097AD07A71F26B2, 0x7E2000A41346A7A7,
+    0x825ECC24C873782F, 0x8ED400668C0C28C8,
+    0xA2F67F2DFA90563B, 0x728900802F0F32FA,
+    0xCBB41EF979346BCA, 0x4F2B40A03AD2FFB9,
+    0xFEA126B7D78186BC, 0xE2F610C84987BFA8,
+    0x9F24B832E6B0F436, 0x0DD9CA7D2DF4D7C9,
+    0xC6EDE63FA05D3143, 0x91503D1C79720DBB,
+    0xF8A95FCF88747D94, 0x75A44C6397CE912A,
+    0x9B69DBE1B548CE7C, 0xC986AFBE3EE11ABA,
+    0xC24452DA229B021B, 0xFBE85BADCE996168,
+    0xF2D56790AB41C2A2, 0xFAE27299423FB9C3,
+    0x97C560BA6B0919A5, 0xDCCD879FC967D41A,
+    0xBDB6B8E905CB600F, 0x5400E987BBC1C920,
+    0xED246723473E3813, 0x290123E9AAB23B68,
+    0x9436C0760C86E30B, 0xF9A0B6720AAF6521,
+    0xB94470938FA89BCE, 0xF808E40E8D5B3E69,
+    0xE7958CB87392C2C2, 0xB60B1D1230B20E04,
+    0x90BD77F3483BB9B9, 0xB1C6F22B5E6F48C2,
+    0xB4ECD5F01A4AA828, 0x1E38AEB6360B1AF3,
+    0xE2280B6C20DD5232, 0x25C6DA63C38DE1B0,
+    0x8D590723948A535F, 0x579C487E5A38AD0E,
+    0xB0AF48EC79ACE837, 0x2D835A9DF0C6D851,
+    0xDCDB1B2798182244, 0xF8E431456CF88E65,
+    0x8A08F0F8BF0F156B, 0x1B8E9ECB641B58FF,
+    0xAC8B2D36EED2DAC5, 0xE272467E3D222F3F,
+    0xD7ADF884AA879177, 0x5B0ED81DCC6ABB0F,
+    0x86CCBB52EA94BAEA, 0x98E947129FC2B4E9,
+    0xA87FEA27A539E9A5, 0x3F2398D747B36224,
+    0xD29FE4B18E88640E, 0x8EEC7F0D19A03AAD,
+    0x83A3EEEEF9153E89, 0x1953CF68300424AC,
+    0xA48CEAAAB75A8E2B, 0x5FA8C3423C052DD7,
+    0xCDB02555653131B6, 0x3792F412CB06794D,
+    0x808E17555F3EBF11, 0xE2BBD88BBEE40BD0,
+    0xA0B19D2AB70E6ED6, 0x5B6ACEAEAE9D0EC4,
+    0xC8DE047564D20A8B, 0xF245825A5A445275,
+    0xFB158592BE068D2E, 0xEED6E2F0F0D56712,
+    0x9CED737BB6C4183D, 0x55464DD69685606B,
+    0xC428D05AA4751E4C, 0xAA97E14C3C26B886,
+    0xF53304714D9265DF, 0xD53DD99F4B3066A8,
+    0x993FE2C6D07B7FAB, 0xE546A8038EFE4029,
+    0xBF8FDB78849A5F96, 0xDE98520472BDD033,
+    0xEF73D256A5C0F77C, 0x963E66858F6D4440,
+    0x95A8637627989AAD, 0xDDE7001379A44AA8,
+    0xBB127C53B17EC159, 0x5560C018580D5D52,
+    0xE9D71B689DDE71AF, 0xAAB8F01E6E10B4A6,
+    0x9226712162AB070D, 0xCAB3961304CA70E8,
+    0xB6B00D69BB55C8D1, 0x3D607B97C5FD0D22,
+    0xE45C10C42A2B3B05, 0x8CB89A7DB77C506A,
+    0x8EB98A7A9A5B04E3, 0x77F3608E92ADB242,
+    0xB267ED1940F1C61C, 0x55F038B237591ED3,
+    0xDF01E85F912E37A3, 0x6B6C46DEC52F6688,
+    0x8B61313BBABCE2C6, 0x2323AC4B3B3DA015,
+    0xAE397D8AA96C1B77, 0xABEC975E0A0D081A,
+    0xD9C7DCED53C72255, 0x96E7BD358C904A21,
+    0x881CEA14545C7575, 0x7E50D64177DA2E54,
+    0xAA242499697392D2, 0xDDE50BD1D5D0B9E9,
+    0xD4AD2DBFC3D07787, 0x955E4EC64B44E864,
+    0x84EC3C97DA624AB4, 0xBD5AF13BEF0B113E,
+    0xA6274BBDD0FADD61, 0xECB1AD8AEACDD58E,
+    0xCFB11EAD453994BA, 0x67DE18EDA5814AF2,
+    0x81CEB32C4B43FCF4, 0x80EACF948770CED7,
+    0xA2425FF75E14FC31, 0xA1258379A94D028D,
+    0xCAD2F7F5359A3B3E, 0x096EE45813A04330,
+    0xFD87B5F28300CA0D, 0x8BCA9D6E188853FC,
+    0x9E74D1B791E07E48, 0x775EA264CF55347E,
+    0xC612062576589DDA, 0x95364AFE032A819E,
+    0xF79687AED3EEC551, 0x3A83DDBD83F52205,
+    0x9ABE14CD44753B52, 0xC4926A9672793543,
+    0xC16D9A0095928A27, 0x75B7053C0F178294,
+    0xF1C90080BAF72CB1, 0x5324C68B12DD6339,
+    0x971DA05074DA7BEE, 0xD3F6FC16EBCA5E04,
+    0xBCE5086492111AEA, 0x88F4BB1CA6BCF585,
+    0xEC1E4A7DB69561A5, 0x2B31E9E3D06C32E6,
+    0x9392EE8E921D5D07, 0x3AFF322E62439FD0,
+    0xB877AA3236A4B449, 0x09BEFEB9FAD487C3,
+    0xE69594BEC44DE15B, 0x4C2EBE687989A9B4,
+    0x901D7CF73AB0ACD9, 0x0F9D37014BF60A11,
+    0xB424DC35095CD80F, 0x538484C19EF38C95,
+    0xE12E13424BB40E13, 0x2865A5F206B06FBA,
+    0x8CBCCC096F5088CB, 0xF93F87B7442E45D4,
+    0xAFEBFF0BCB24AAFE, 0xF78F69A51539D749,
+    0xDBE6FECEBDEDD5BE, 0xB573440E5A884D1C,
+    0x89705F4136B4A597, 0x31680A88F8953031,
+    0xABCC77118461CEFC, 0xFDC20D2B36BA7C3E,
+    0xD6BF94D5E57A42BC, 0x3D32907604691B4D,
+    0x8637BD05AF6C69B5, 0xA63F9A49C2C1B110,
+    0xA7C5AC471B478423, 0x0FCF80DC33721D54,
+    0xD1B71758E219652B, 0xD3C36113404EA4A9,
+    0x83126E978D4FDF3B, 0x645A1CAC083126EA,
+    0xA3D70A3D70A3D70A, 0x3D70A3D70A3D70A4,
+    0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCD,
+    0x8000000000000000, 0x0000000000000000,
+    0xA000000000000000, 0x0000000000000000,
+    0xC800000000000000, 0x0000000000000000,
+    0xFA00000000000000, 0x0000000000000000,
+    0x9C40000000000000, 0x0000000000000000,
+    0xC350000000000000, 0x0000000000000000,
+    0xF424000000000000, 0x0000000000000000,
+    0x9896800000000000, 0x0000000000000000,
+    0xBEBC200000000000, 0x0000000000000000,
+    0xEE6B280000000000, 0x0000000000000000,
+    0x9502F90000000000, 0x0000000000000000,
+    0xBA43B74000000000, 0x0000000000000000,
+    0xE8D4A51000000000, 0x0000000000000000,
+    0x9184E72A00000000, 0x0000000000000000,
+    0xB5E620F480000000, 0x0000000000000000,
+    0xE35FA931A0000000, 0x0000000000000000,
+    0x8E1BC9BF04000000, 0x0000000000000000,
+    0xB1A2BC2EC5000000, 0x0000000000000000,
+    0xDE0B6B3A76400000, 0x0000000000000000,
+    0x8AC7230489E80000, 0x0000000000000000,
+    0xAD78EBC5AC620000, 0x0000000000000000,
+    0xD8D726B7177A8000, 0x0000000000000000,
+    0x878678326EAC9000, 0x0000000000000000,
+    0xA968163F0A57B400, 0x0000000000000000,
+    0xD3C21BCECCEDA100, 0x0000000000000000,
+    0x84595161401484A0, 0x0000000000000000,
+    0xA56FA5B99019A5C8, 0x0000000000000000,
+    0xCECB8F27F4200F3A, 0x0000000000000000,
+    0x813F3978F8940984, 0x4000000000000000,
+    0xA18F07D736B90BE5, 0x5000000000000000,
+    0xC9F2C9CD04674EDE, 0xA400000000000000,
+    0xFC6F7C4045812296, 0x4D00000000000000,
+    0x9DC5ADA82B70B59D, 0xF020000000000000,
+    0xC5371912364CE305, 0x6C28000000000000,
+    0xF684DF56C3E01BC6, 0xC732000000000000,
+    0x9A130B963A6C115C, 0x3C7F400000000000,
+    0xC097CE7BC90715B3, 0x4B9F100000000000,
+    0xF0BDC21ABB48DB20, 0x1E86D40000000000,
+    0x96769950B50D88F4, 0x1314448000000000,
+    0xBC143FA4E250EB31, 0x17D955A000000000,
+    0xEB194F8E1AE525FD, 0x5DCFAB0800000000,
+    0x92EFD1B8D0CF37BE, 0x5AA1CAE500000000,
+    0xB7ABC627050305AD, 0xF14A3D9E40000000,
+    0xE596B7B0C643C719, 0x6D9CCD05D0000000,
+    0x8F7E32CE7BEA5C6F, 0xE4820023A2000000,
+    0xB35DBF821AE4F38B, 0xDDA2802C8A800000,
+    0xE0352F62A19E306E, 0xD50B2037AD200000,
+    0x8C213D9DA502DE45, 0x4526F422CC340000,
+    0xAF298D050E4395D6, 0x9670B12B7F410000,
+    0xDAF3F04651D47B4C, 0x3C0CDD765F114000,
+    0x88D8762BF324CD0F, 0xA5880A69FB6AC800,
+    0xAB0E93B6EFEE0053, 0x8EEA0D047A457A00,
+    0xD5D238A4ABE98068, 0x72A4904598D6D880,
+    0x85A36366EB71F041, 0x47A6DA2B7F864750,
+    0xA70C3C40A64E6C51, 0x999090B65F67D924,
+    0xD0CF4B50CFE20765, 0xFFF4B4E3F741CF6D,
+    0x82818F1281ED449F, 0xBFF8F10E7A8921A4,
+    0xA321F2D7226895C7, 0xAFF72D52192B6A0D,
+    0xCBEA6F8CEB02BB39, 0x9BF4F8A69F764490,
+    0xFEE50B7025C36A08, 0x02F236D04753D5B4,
+    0x9F4F2726179A2245, 0x01D762422C946590,
+    0xC722F0EF9D80AAD6, 0x424D3AD2B7B97EF5,
+    0xF8EBAD2B84E0D58B, 0xD2E0898765A7DEB2,
+    0x9B934C3B330C8577, 0x63CC55F49F88EB2F,
+    0xC2781F49FFCFA6D5, 0x3CBF6B71C76B25FB,
+    0xF316271C7FC3908A, 0x8BEF464E3945EF7A,
+    0x97EDD871CFDA3A56, 0x97758BF0E3CBB5AC,
+    0xBDE94E8E43D0C8EC, 0x3D52EEED1CBEA317,
+    0xED63A231D4C4FB27, 0x4CA7AAA863EE4BDD,
+    0x945E455F24FB1CF8, 0x8FE8CAA93E74EF6A,
+    0xB975D6B6EE39E436, 0xB3E2FD538E122B44,
+    0xE7D34C64A9C85D44, 0x60DBBCA87196B616,
+    0x90E40FBEEA1D3A4A, 0xBC8955E946FE31CD,
+    0xB51D13AEA4A488DD, 0x6BABAB6398BDBE41,
+    0xE264589A4DCDAB14, 0xC696963C7EED2DD1,
+    0x8D7EB76070A08AEC, 0xFC1E1DE5CF543CA2,
+    0xB0DE65388CC8ADA8, 0x3B25A55F43294BCB,
+    0xDD15FE86AFFAD912, 0x49EF0EB713F39EBE,
+    0x8A2DBF142DFCC7AB, 0x6E3569326C784337,
+    0xACB92ED9397BF996, 0x49C2C37F07965404,
+    0xD7E77A8F87DAF7FB, 0xDC33745EC97BE906,
+    0x86F0AC99B4E8DAFD, 0x69A028BB3DED71A3,
+    0xA8ACD7C0222311BC, 0xC40832EA0D68CE0C,
+    0xD2D80DB02AABD62B, 0xF50A3FA490C30190,
+    0x83C7088E1AAB65DB, 0x792667C6DA79E0FA,
+    0xA4B8CAB1A1563F52, 0x577001B891185938,
+    0xCDE6FD5E09ABCF26, 0xED4C0226B55E6F86,
+    0x80B05E5AC60B6178, 0x544F8158315B05B4,
+    0xA0DC75F1778E39D6, 0x696361AE3DB1C721,
+    0xC913936DD571C84C, 0x03BC3A19CD1E38E9,
+    0xFB5878494ACE3A5F, 0x04AB48A04065C723,
+    0x9D174B2DCEC0E47B, 0x62EB0D64283F9C76,
+    0xC45D1DF942711D9A, 0x3BA5D0BD324F8394,
+    0xF5746577930D6500, 0xCA8F44EC7EE36479,
+    0x9968BF6ABBE85F20, 0x7E998B13CF4E1ECB,
+    0xBFC2EF456AE276E8, 0x9E3FEDD8C321A67E,
+    0xEFB3AB16C59B14A2, 0xC5CFE94EF3EA101E,
+    0x95D04AEE3B80ECE5, 0xBBA1F1D158724A12,
+    0xBB445DA9CA61281F, 0x2A8A6E45AE8EDC97,
+    0xEA1575143CF97226, 0xF52D09D71A3293BD,
+    0x924D692CA61BE758, 0x593C2626705F9C56,
+    0xB6E0C377CFA2E12E, 0x6F8B2FB00C77836C,
+    0xE498F455C38B997A, 0x0B6DFB9C0F956447,
+    0x8EDF98B59A373FEC, 0x4724BD4189BD5EAC,
+    0xB2977EE300C50FE7, 0x58EDEC91EC2CB657,
+    0xDF3D5E9BC0F653E1, 0x2F2967B66737E3ED,
+    0x8B865B215899F46C, 0xBD79E0D20082EE74,
+    0xAE67F1E9AEC07187, 0xECD8590680A3AA11,
+    0xDA01EE641A708DE9, 0xE80E6F4820CC9495,
+    0x884134FE908658B2, 0x3109058D147FDCDD,
+    0xAA51823E34A7EEDE, 0xBD4B46F0599FD415,
+    0xD4E5E2CDC1D1EA96, 0x6C9E18AC7007C91A,
+    0x850FADC09923329E, 0x03E2CF6BC604DDB0,
+    0xA6539930BF6BFF45, 0x84DB8346B786151C,
+    0xCFE87F7CEF46FF16, 0xE612641865679A63,
+    0x81F14FAE158C5F6E, 0x4FCB7E8F3F60C07E,
+    0xA26DA3999AEF7749, 0xE3BE5E330F38F09D,
+    0xCB090C8001AB551C, 0x5CADF5BFD3072CC5,
+    0xFDCB4FA002162A63, 0x73D9732FC7C8F7F6,
+    0x9E9F11C4014DDA7E, 0x2867E7FDDCDD9AFA,
+    0xC646D63501A1511D, 0xB281E1FD541501B8,
+    0xF7D88BC24209A565, 0x1F225A7CA91A4226,
+    0x9AE757596946075F, 0x3375788DE9B06958,
+    0xC1A12D2FC3978937, 0x0052D6B1641C83AE,
+    0xF209787BB47D6B84, 0xC0678C5DBD23A49A,
+    0x9745EB4D50CE6332, 0xF840B7BA963646E0,
+    0xBD176620A501FBFF, 0xB650E5A93BC3D898,
+    0xEC5D3FA8CE427AFF, 0xA3E51F138AB4CEBE,
+    0x93BA47C980E98CDF, 0xC66F336C36B10137,
+    0xB8A8D9BBE123F017, 0xB80B0047445D4184,
+    0xE6D3102AD96CEC1D, 0xA60DC059157491E5,
+    0x9043EA1AC7E41392, 0x87C89837AD68DB2F,
+    0xB454E4A179DD1877, 0x29BABE4598C311FB,
+    0xE16A1DC9D8545E94, 0xF4296DD6FEF3D67A,
+    0x8CE2529E2734BB1D, 0x1899E4A65F58660C,
+    0xB01AE745B101E9E4, 0x5EC05DCFF72E7F8F,
+    0xDC21A1171D42645D, 0x76707543F4FA1F73,
+    0x899504AE72497EBA, 0x6A06494A791C53A8,
+    0xABFA45DA0EDBDE69, 0x0487DB9D17636892,
+    0xD6F8D7509292D603, 0x45A9D2845D3C42B6,
+    0x865B86925B9BC5C2, 0x0B8A2392BA45A9B2,
+    0xA7F26836F282B732, 0x8E6CAC7768D7141E,
+    0xD1EF0244AF2364FF, 0x3207D795430CD926,
+    0x8335616AED761F1F, 0x7F44E6BD49E807B8,
+    0xA402B9C5A8D3A6E7, 0x5F16206C9C6209A6,
+    0xCD036837130890A1, 0x36DBA887C37A8C0F,
+    0x802221226BE55A64, 0xC2494954DA2C9789,
+    0xA02AA96B06DEB0FD, 0xF2DB9BAA10B7BD6C,
+    0xC83553C5C8965D3D, 0x6F92829494E5ACC7,
+    0xFA42A8B73ABBF48C, 0xCB772339BA1F17F9,
+    0x9C69A97284B578D7, 0xFF2A760414536EFB,
+    0xC38413CF25E2D70D, 0xFEF5138519684ABA,
+    0xF46518C2EF5B8CD1, 0x7EB258665FC25D69,
+    0x98BF2F79D5993802, 0xEF2F773FFBD97A61,
+    0xBEEEFB584AFF8603, 0xAAFB550FFACFD8FA,
+    0xEEAABA2E5DBF6784, 0x95BA2A53F983CF38,
+    0x952AB45CFA97A0B2, 0xDD945A747BF26183,
+    0xBA756174393D88DF, 0x94F971119AEEF9E4,
+    0xE912B9D1478CEB17, 0x7A37CD5601AAB85D,
+    0x91ABB422CCB812EE, 0xAC62E055C10AB33A,
+    0xB616A12B7FE617AA, 0x577B986B314D6009,
+    0xE39C49765FDF9D94, 0xED5A7E85FDA0B80B,
+    0x8E41ADE9FBEBC27D, 0x14588F13BE847307,
+    0xB1D219647AE6B31C, 0x596EB2D8AE258FC8,
+    0xDE469FBD99A05FE3, 0x6FCA5F8ED9AEF3BB,
+    0x8AEC23D680043BEE, 0x25DE7BB9480D5854,
+    0xADA72CCC20054AE9, 0xAF561AA79A10AE6A,
+    0xD910F7FF28069DA4, 0x1B2BA1518094DA04,
+    0x87AA9AFF79042286, 0x90FB44D2F05D0842,
+    0xA99541BF57452B28, 0x353A1607AC744A53,
+    0xD3FA922F2D1675F2, 0x42889B8997915CE8,
+    0x847C9B5D7C2E09B7, 0x69956135FEBADA11,
+    0xA59BC234DB398C25, 0x43FAB9837E699095,
+    0xCF02B2C21207EF2E, 0x94F967E45E03F4BB,
+    0x8161AFB94B44F57D, 0x1D1BE0EEBAC278F5,
+    0xA1BA1BA79E1632DC, 0x6462D92A69731732,
+    0xCA28A291859BBF93, 0x7D7B8F7503CFDCFE,
+    0xFCB2CB35E702AF78, 0x5CDA735244C3D43E,
+    0x9DEFBF01B061ADAB, 0x3A0888136AFA64A7,
+    0xC56BAEC21C7A1916, 0x088AAA1845B8FDD0,
+    0xF6C69A72A3989F5B, 0x8AAD549E57273D45,
+    0x9A3C2087A63F6399, 0x36AC54E2F678864B,
+    0xC0CB28A98FCF3C7F, 0x84576A1BB416A7DD,
+    0xF0FDF2D3F3C30B9F, 0x656D44A2A11C51D5,
+    0x969EB7C47859E743, 0x9F644AE5A4B1B325,
+    0xBC4665B596706114, 0x873D5D9F0DDE1FEE,
+    0xEB57FF22FC0C7959, 0xA90CB506D155A7EA,
+    0x9316FF75DD87CBD8, 0x09A7F12442D588F2,
+    0xB7DCBF5354E9BECE, 0x0C11ED6D538AEB2F,
+    0xE5D3EF282A242E81, 0x8F1668C8A86DA5FA,
+    0x8FA475791A569D10, 0xF96E017D694487BC,
+    0xB38D92D760EC4455, 0x37C981DCC395A9AC,
+    0xE070F78D3927556A, 0x85BBE253F47B1417,
+    0x8C469AB843B89562, 0x93956D7478CCEC8E,
+    0xAF58416654A6BABB, 0x387AC8D1970027B2,
+    0xDB2E51BFE9D0696A, 0x06997B05FCC0319E,
+    0x88FCF317F22241E2, 0x441FECE3BDF81F03,
+    0xAB3C2FDDEEAAD25A, 0xD527E81CAD7626C3,
+    0xD60B3BD56A5586F1, 0x8A71E223D8D3B074,
+    0x85C7056562757456, 0xF6872D5667844E49,
+    0xA738C6BEBB12D16C, 0xB428F8AC016561DB,
+    0xD106F86E69D785C7, 0xE13336D701BEBA52,
+    0x82A45B450226B39C, 0xECC0024661173473,
+    0xA34D721642B06084, 0x27F002D7F95D0190,
+    0xCC20CE9BD35C78A5, 0x31EC038DF7B441F4,
+    0xFF290242C83396CE, 0x7E67047175A15271,
+    0x9F79A169BD203E41, 0x0F0062C6E984D386,
+    0xC75809C42C684DD1, 0x52C07B78A3E60868,
+    0xF92E0C3537826145, 0xA7709A56CCDF8A82,
+    0x9BBCC7A142B17CCB, 0x88A66076400BB691,
+    0xC2ABF989935DDBFE, 0x6ACFF893D00EA435,
+    0xF356F7EBF83552FE, 0x0583F6B8C4124D43,
+    0x98165AF37B2153DE, 0xC3727A337A8B704A,
+    0xBE1BF1B059E9A8D6, 0x744F18C0592E4C5C,
+    0xEDA2EE1C7064130C, 0x1162DEF06F79DF73,
+    0x9485D4D1C63E8BE7, 0x8ADDCB5645AC2BA8,
+    0xB9A74A0637CE2EE1, 0x6D953E2BD7173692,
+    0xE8111C87C5C1BA99, 0xC8FA8DB6CCDD0437,
+    0x910AB1D4DB9914A0, 0x1D9C9892400A22A2,
+    0xB54D5E4A127F59C8, 0x2503BEB6D00CAB4B,
+    0xE2A0B5DC971F303A, 0x2E44AE64840FD61D,
+    0x8DA471A9DE737E24, 0x5CEAECFED289E5D2,
+    0xB10D8E1456105DAD, 0x7425A83E872C5F47,
+    0xDD50F1996B947518, 0xD12F124E28F77719,
+    0x8A5296FFE33CC92F, 0x82BD6B70D99AAA6F,
+    0xACE73CBFDC0BFB7B, 0x636CC64D1001550B,
+    0xD8210BEFD30EFA5A, 0x3C47F7E05401AA4E,
+    0x8714A775E3E95C78, 0x65ACFAEC34810A71,
+    0xA8D9D1535CE3B396, 0x7F1839A741A14D0D,
+    0xD31045A8341CA07C, 0x1EDE48111209A050,
+    0x83EA2B892091E44D, 0x934AED0AAB460432,
+    0xA4E4B66B68B65D60, 0xF81DA84D5617853F,
+    0xCE1DE40642E3F4B9, 0x36251260AB9D668E,
+    0x80D2AE83E9CE78F3, 0xC1D72B7C6B426019,
+    0xA1075A24E4421730, 0xB24CF65B8612F81F,
+    0xC94930AE1D529CFC, 0xDEE033F26797B627,
+    0xFB9B7CD9A4A7443C, 0x169840EF017DA3B1,
+    0x9D412E0806E88AA5, 0x8E1F289560EE864E,
+    0xC491798A08A2AD4E, 0xF1A6F2BAB92A27E2,
+    0xF5B5D7EC8ACB58A2, 0xAE10AF696774B1DB,
+    0x9991A6F3D6BF1765, 0xACCA6DA1E0A8EF29,
+    0xBFF610B0CC6EDD3F, 0x17FD090A58D32AF3,
+    0xEFF394DCFF8A948E, 0xDDFC4B4CEF07F5B0,
+    0x95F83D0A1FB69CD9, 0x4ABDAF101564F98E,
+    0xBB764C4CA7A4440F, 0x9D6D1AD41ABE37F1,
+    0xEA53DF5FD18D5513, 0x84C86189216DC5ED,
+    0x92746B9BE2F8552C, 0x32FD3CF5B4E49BB4,
+    0xB7118682DBB66A77, 0x3FBC8C33221DC2A1,
+    0xE4D5E82392A40515, 0x0FABAF3FEAA5334A,
+    0x8F05B1163BA6832D, 0x29CB4D87F2A7400E,
+    0xB2C71D5BCA9023F8, 0x743E20E9EF511012,
+    0xDF78E4B2BD342CF6, 0x914DA9246B255416,
+    0x8BAB8EEFB6409C1A, 0x1AD089B6C2F7548E,
+    0xAE9672ABA3D0C320, 0xA184AC2473B529B1,
+    0xDA3C0F568CC4F3E8, 0xC9E5D72D90A2741E,
+    0x8865899617FB1871, 0x7E2FA67C7A658892,
+    0xAA7EEBFB9DF9DE8D, 0xDDBB901B98FEEAB7,
+    0xD51EA6FA85785631, 0x552A74227F3EA565,
+    0x8533285C936B35DE, 0xD53A88958F87275F,
+    0xA67FF273B8460356, 0x8A892ABAF368F137,
+    0xD01FEF10A657842C, 0x2D2B7569B0432D85,
+    0x8213F56A67F6B29B, 0x9C3B29620E29FC73,
+    0xA298F2C501F45F42, 0x8349F3BA91B47B8F,
+    0xCB3F2F7642717713, 0x241C70A936219A73,
+    0xFE0EFB53D30DD4D7, 0xED238CD383AA0110,
+    0x9EC95D1463E8A506, 0xF4363804324A40AA,
+    0xC67BB4597CE2CE48, 0xB143C6053EDCD0D5,
+    0xF81AA16FDC1B81DA, 0xDD94B7868E94050A,
+    0x9B10A4E5E9913128, 0xCA7CF2B4191C8326,
+    0xC1D4CE1F63F57D72, 0xFD1C2F611F63A3F0,
+    0xF24A01A73CF2DCCF, 0xBC633B39673C8CEC,
+    0x976E41088617CA01, 0xD5BE0503E085D813,
+    0xBD49D14AA79DBC82, 0x4B2D8644D8A74E18,
+    0xEC9C459D51852BA2, 0xDDF8E7D60ED1219E,
+    0x93E1AB8252F33B45, 0xCABB90E5C942B503,
+    0xB8DA1662E7B00A17, 0x3D6A751F3B936243,
+    0xE7109BFBA19C0C9D, 0x0CC512670A783AD4,
+    0x906A617D450187E2, 0x27FB2B80668B24C5,
+    0xB484F9DC9641E9DA, 0xB1F9F660802DEDF6,
+    0xE1A63853BBD26451, 0x5E7873F8A0396973,
+    0x8D07E33455637EB2, 0xDB0B487B6423E1E8,
+    0xB049DC016ABC5E5F, 0x91CE1A9A3D2CDA62,
+    0xDC5C5301C56B75F7, 0x7641A140CC7810FB,
+    0x89B9B3E11B6329BA, 0xA9E904C87FCB0A9D,
+    0xAC2820D9623BF429, 0x546345FA9FBDCD44,
+    0xD732290FBACAF133, 0xA97C177947AD4095,
+    0x867F59A9D4BED6C0, 0x49ED8EABCCCC485D,
+    0xA81F301449EE8C70, 0x5C68F256BFFF5A74,
+    0xD226FC195C6A2F8C, 0x73832EEC6FFF3111,
+    0x83585D8FD9C25DB7, 0xC831FD53C5FF7EAB,
+    0xA42E74F3D032F525, 0xBA3E7CA8B77F5E55,
+    0xCD3A1230C43FB26F, 0x28CE1BD2E55F35EB,
+    0x80444B5E7AA7CF85, 0x7980D163CF5B81B3,
+    0xA0555E361951C366, 0xD7E105BCC332621F,
+    0xC86AB5C39FA63440, 0x8DD9472BF3FEFAA7,
+    0xFA856334878FC150, 0xB14F98F6F0FEB951,
+    0x9C935E00D4B9D8D2, 0x6ED1BF9A569F33D3,
+    0xC3B8358109E84F07, 0x0A862F80EC4700C8,
+    0xF4A642E14C6262C8, 0xCD27BB612758C0FA,
+    0x98E7E9CCCFBD7DBD, 0x8038D51CB897789C,
+    0xBF21E44003ACDD2C, 0xE0470A63E6BD56C3,
+    0xEEEA5D5004981478, 0x1858CCFCE06CAC74,
+    0x95527A5202DF0CCB, 0x0F37801E0C43EBC8,
+    0xBAA718E68396CFFD, 0xD30560258F54E6BA,
+    0xE950DF20247C83FD, 0x47C6B82EF32A2069,
+    0x91D28B7416CDD27E, 0x4CDC331D57FA5441,
+    0xB6472E511C81471D, 0xE0133FE4ADF8E952,
+    0xE3D8F9E563A198E5, 0x58180FDDD97723A6,
+    0x8E679C2F5E44FF8F, 0x570F09EAA7EA7648,
+};
+
+static inline uint32_t plain_json_intern_clz64(uint64_t value) {
+    json_assert(value != 0);
+    #ifdef __GNUC__
+    return (uint32_t)__builtin_clzll(value);
+    #else
+    uint32_t count = 0;
+    while ((value & ((uint64_t)1 << 63)) == 0) {
+        value <<= 1;
+        count++;
+    }
+    return count;
+    #endif
+}
+
+/* Full 64x64 bit multiplication, returns the lower half */
+static inline uint64_t plain_json_intern_mul128(uint64_t a, uint64_t b, uint64_t *high) {
+    #ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 plain_json_uint128;
+    const plain_json_uint128 product = (plain_json_uint128)a * b;
+    (*high) = (uint64_t)(product >> 64);
+    return (uint64_t)product;
+    #else
+    const uint64_t a_low = a & 0xFFFFFFFF;
+    const uint64_t a_high = a >> 32;
+    const uint64_t b_low = b & 0xFFFFFFFF;
+    const uint64_t b_high = b >> 32;
+
+    const uint64_t low_low = a_low * b_low;
+    const uint64_t high_low = a_high * b_low;
+    const uint64_t low_high = a_low * b_high;
+    const uint64_t cross = (low_low >> 32) + (high_low & 0xFFFFFFFF) + low_high;
+
+    (*high) = a_high * b_high + (high_low >> 32) + (cross >> 32);
+    return (cross << 32) | (low_low & 0xFFFFFFFF);
+    #endif
+}
+
+static plain_json_FloatBits
+plain_json_intern_eisel_lemire(const plain_json_FloatFormat *format, int64_t q, uint64_t w) {
+    plain_json_FloatBits result = { 0, 0 };
+
+    if (w == 0 || q < format->smallest_power_of_ten) {
+        return result;
+    }
+
+    if (q > format->largest_power_of_ten) {
+        result.power2 = format->infinite_power;
+        return result;
+    }
+
+    const uint32_t leading_zeros = plain_json_intern_clz64(w);
+    w <<= leading_zeros;
+
+    /* Only the bits that end up in the mantissa (plus 3 bits for rounding) need to be exact. The
+     * lower half of 5^q only matters if they could be affected by a carry. */
+    const uint32_t index = 2 * (uint32_t)(q + 342);
+    const uint64_t precision_mask = UINT64_MAX >> (format->mantissa_bits + 3);
+
+    uint64_t high = 0;
+    uint64_t low = plain_json_intern_mul128(w, plain_json_intern_power_of_five[index], &high);
+    if ((high & precision_mask) == precision_mask) {
+        uint64_t second_high = 0;
+        plain_json_intern_mul128(w, plain_json_intern_power_of_five[index + 1], &second_high);
+        low += second_high;
+        if (second_high > low) {
+            high++;
+        }
+    }
+
+    const int32_t upper_bit = (int32_t)(high >> 63);
+    const uint32_t shift = (uint32_t)upper_bit + 64 - format->mantissa_bits - 3;
+    /* floor(log2(10^q)) + 63 */
+    const int32_t power = (int32_t)(((152170 + 65536) * (int32_t)q) >> 16) + 63;
+
+    result.mantissa = high >> shift;
+    result.power2 =
+        power + upper_bit - (int32_t)leading_zeros - format->minimum_exponent;
+
+    if (result.power2 <= 0) {
+        /* Subnormal, or too small to be represented at all */
+        if (-result.power2 + 1 >= 64) {
+            result.mantissa = 0;
+            result.power2 = 0;
+            return result;
+        }
+
+        result.mantissa >>= -result.power2 + 1;
+        result.mantissa += result.mantissa & 1;
+        result.mantissa >>= 1;
+        /* Rounding up might turn the number into a normal float */
+        result.power2 = result.mantissa < ((uint64_t)1 << format->mantissa_bits) ? 0 : 1;
+        return result;
+    }
+
+    /* Exactly halfway between two floats: round to even instead of up. This can only happen if
+     * 5^q fits into 64 bits. */
+    if (low <= 1 && q >= format->min_exponent_round_to_even &&
+        q <= format->max_exponent_round_to_even && (result.mantissa & 3) == 1 &&
+        (result.mantissa << shift) == high) {
+        result.mantissa &= ~(uint64_t)1;
+    }
+
+    result.mantissa += result.mantissa & 1;
+    result.mantissa >>= 1;
+    if (result.mantissa >= ((uint64_t)2 << format->mantissa_bits)) {
+        result.mantissa = (uint64_t)1 << format->mantissa_bits;
+        result.power2++;
+    }
+
+    result.mantissa &= ~((uint64_t)1 << format->mantissa_bits);
+    if (result.power2 >= format->infinite_power) {
+        result.power2 = format->infinite_power;
+        result.mantissa = 0;
+    }
+
+    return result;
+}
+
+static void plain_json_intern_decimal_trim(plain_json_Decimal *decimal) {
+    while (decimal->count > 0 && decimal->digits[decimal->count - 1] == 0) {
+        decimal->count--;
+    }
+
+    if (decimal->count == 0) {
+        decimal->point = 0;
+    }
+}
+
+/* 'text' spans the digits (and decimal point) of a number, without its sign and exponent */
+static void plain_json_intern_decimal_init(
+    plain_json_Decimal *decimal, const uint8_t *text, uintptr_t length, int64_t exponent
+) {
+    int64_t digit_count = 0;
+    int64_t point = 0;
+    bool has_point = false;
+
+    decimal->is_truncated = false;
+
+    for (uintptr_t i = 0; i < length; i++) {
+        if (text[i] == '.') {
+            has_point = true;
+            point = digit_count;
+            continue;
+        }
+
+        /* Leading zeros only move the decimal point */
+        if (text[i] == '0' && digit_count == 0) {
+            point--;
+            continue;
+        }
+
+        if (digit_count < PLAIN_JSON_DECIMAL_DIGITS) {
+            decimal->digits[digit_count] = text[i] - '0';
+        } else if (text[i] != '0') {
+            decimal->is_truncated = true;
+        }
+        digit_count++;
+    }
+
+    if (!has_point) {
+        point = digit_count;
+    }
+
+    /* Anything beyond these bounds is zero or infinite anyway */
+    point += exponent;
+    if (point > 100000) {
+        point = 100000;
+    } else if (point < -100000) {
+        point = -100000;
+    }
+
+    decimal->count = (int32_t)(digit_count < PLAIN_JSON_DECIMAL_DIGITS ? digit_count
+                                                                       : PLAIN_JSON_DECIMAL_DIGITS);
+    decimal->point = (int32_t)point;
+    plain_json_intern_decimal_trim(decimal);
+}
+
+static void plain_json_intern_decimal_right_shift(plain_json_Decimal *decimal, uint32_t shift) {
+    const uint64_t mask = ((uint64_t)1 << shift) - 1;
+    int32_t read_index = 0;
+    int32_t write_index = 0;
+    uint64_t value = 0;
+
+    /* Find the first digit of the result */
+    for (; (value >> shift) == 0; read_index++) {
+        if (read_index >= decimal->count) {
+            if (value == 0) {
+                decimal->count = 0;
+                return;
+            }
+
+            while ((value >> shift) == 0) {
+                value *= 10;
+                read_index++;
+            }
+            break;
+        }
+
+        value = value * 10 + decimal->digits[read_index];
+    }
+
+    decimal->point -= read_index - 1;
+
+    for (; read_index < decimal->count; read_index++) {
+        const uint8_t digit = (uint8_t)(value >> shift);
+        value &= mask;
+        decimal->digits[write_index++] = digit;
+        value = value * 10 + decimal->digits[read_index];
+    }
+
+    while (value > 0) {
+        const uint8_t digit = (uint8_t)(value >> shift);
+        value &= mask;
+        if (write_index < PLAIN_JSON_DECIMAL_DIGITS) {
+            decimal->digits[write_index++] = digit;
+        } else if (digit > 0) {
+            decimal->is_truncated = true;
+        }
+        value *= 10;
+    }
+
+    decimal->count = write_index;
+    plain_json_intern_decimal_trim(decimal);
+}
+
+static void plain_json_intern_decimal_left_shift(plain_json_Decimal *decimal, uint32_t shift) {
+    /* The result has at most as many new digits as 2^shift. The digits are written back to
+     * front, moving them in place afterwards if there is one less. */
+    int32_t new_digits = 0;
+    for (uint64_t power = (uint64_t)1 << shift; power > 0; power /= 10) {
+        new_digits++;
+    }
+
+    int32_t write_index = decimal->count + new_digits;
+    uint64_t value = 0;
+
+    for (int32_t read_index = decimal->count - 1; read_index >= 0; read_index--) {
+        value += (uint64_t)decimal->digits[read_index] << shift;
+        const uint64_t quotient = value / 10;
+        decimal->digits[--write_index] = (uint8_t)(value - 10 * quotient);
+        value = quotient;
+    }
+
+    while (value > 0) {
+        const uint64_t quotient = value / 10;
+        decimal->digits[--write_index] = (uint8_t)(value - 10 * quotient);
+        value = quotient;
+    }
+
+    if (write_index > 0) {
+        json_assert(write_index == 1);
+        for (int32_t i = 0; i < decimal->count + new_digits - 1; i++) {
+            decimal->digits[i] = decimal->digits[i + 1];
+        }
+        new_digits--;
+    }
+
+    decimal->count += new_digits;
+    decimal->point += new_digits;
+
+    if (decimal->count > PLAIN_JSON_DECIMAL_DIGITS) {
+        for (int32_t i = PLAIN_JSON_DECIMAL_DIGITS; i < decimal->count; i++) {
+            if (decimal->digits[i] != 0) {
+                decimal->is_truncated = true;
+            }
+        }
+        decimal->count = PLAIN_JSON_DECIMAL_DIGITS;
+    }
+
+    plain_json_intern_decimal_trim(decimal);
+}
+
+/* Multiply (shift > 0) or divide (shift < 0) by 2^shift */
+static void plain_json_intern_decimal_shift(plain_json_Decimal *decimal, int32_t shift) {
+    if (decimal->count == 0) {
+        return;
+    }
+
+    while (shift > PLAIN_JSON_DECIMAL_MAX_SHIFT) {
+        plain_json_intern_decimal_left_shift(decimal, PLAIN_JSON_DECIMAL_MAX_SHIFT);
+        shift -= PLAIN_JSON_DECIMAL_MAX_SHIFT;
+    }
+
+    while (shift < -PLAIN_JSON_DECIMAL_MAX_SHIFT) {
+        plain_json_intern_decimal_right_shift(decimal, PLAIN_JSON_DECIMAL_MAX_SHIFT);
+        shift += PLAIN_JSON_DECIMAL_MAX_SHIFT;
+    }
+
+    if (shift > 0) {
+        plain_json_intern_decimal_left_shift(decimal, (uint32_t)shift);
+    } else if (shift < 0) {
+        plain_json_intern_decimal_right_shift(decimal, (uint32_t)-shift);
+    }
+}
+
+/* Integer part of the decimal, rounded to nearest even */
+static uint64_t plain_json_intern_decimal_round(const plain_json_Decimal *decimal) {
+    if (decimal->point > 20) {
+        return UINT64_MAX;
+    }
+
+    uint64_t value = 0;
+    int32_t i = 0;
+    for (; i < decimal->point && i < decimal->count; i++) {
+        value = value * 10 + decimal->digits[i];
+    }
+    for (; i < decimal->point; i++) {
+        value *= 10;
+    }
+
+    const int32_t next = decimal->point;
+    if (next >= 0 && next < decimal->count) {
+        bool round_up = decimal->digits[next] >= 5;
+
+        /* Exactly halfway, unless digits were dropped */
+        if (decimal->digits[next] == 5 && next + 1 == decimal->count && !decimal->is_truncated) {
+            round_up = next > 0 && (decimal->digits[next - 1] % 2) == 1;
+        }
+
+        if (round_up) {
+            value++;
+        }
+    }
+
+    return value;
+}
+
+static plain_json_FloatBits
+plain_json_intern_decimal_to_float(const plain_json_FloatFormat *format, plain_json_Decimal *decimal) {
+    /* Shifts that move the decimal point by up to 8 digits without running out of digits */
+    static const uint8_t power_table[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+
+    plain_json_FloatBits result = { 0, 0 };
+    const int32_t bias = format->minimum_exponent;
+    int32_t exponent = 0;
+
+    if (decimal->count == 0 || decimal->point < -330) {
+        return result;
+    }
+
+    if (decimal->point > 310) {
+        result.power2 = format->infinite_power;
+        return result;
+    }
+
+    /* Scale into [0.5, 1) */
+    while (decimal->point > 0) {
+        const int32_t shift = decimal->point >= 9 ? 27 : power_table[decimal->point];
+        plain_json_intern_decimal_shift(decimal, -shift);
+        exponent += shift;
+    }
+
+    while (decimal->point < 0 || (decimal->point == 0 && decimal->digits[0] < 5)) {
+        const int32_t shift = -decimal->point >= 9 ? 27 : power_table[-decimal->point];
+        plain_json_intern_decimal_shift(decimal, shift);
+        exponent -= shift;
+    }
+
+    /* Floats use [1, 2) */
+    exponent--;
+
+    /* Subnormals have the smallest exponent */
+    if (exponent < bias + 1) {
+        plain_json_intern_decimal_shift(decimal, -(bias + 1 - exponent));
+        exponent = bias + 1;
+    }
+
+    if (exponent - bias >= format->infinite_power) {
+        result.power2 = format->infinite_power;
+        return result;
+    }
+
+    plain_json_intern_decimal_shift(decimal, (int32_t)format->mantissa_bits + 1);
+    uint64_t mantissa = plain_json_intern_decimal_round(decimal);
+
+    /* Rounding might have added a bit */
+    if (mantissa == ((uint64_t)2 << format->mantissa_bits)) {
+        mantissa >>= 1;
+        exponent++;
+
+        if (exponent - bias >= format->infinite_power) {
+            result.power2 = format->infinite_power;
+            return result;
+        }
+    }
+
+    if ((mantissa & ((uint64_t)1 << format->mantissa_bits)) == 0) {
+        exponent = bias;
+    }
+
+    result.mantissa = mantissa & (((uint64_t)1 << format->mantissa_bits) - 1);
+    result.power2 = exponent - bias;
+    return result;
+}
+
+/* 'w * 10^q' is the number with its significand truncated to 19 digits, 'text' spans its
+ * digits and is only needed if the significand was truncated. */
+static plain_json_FloatBits plain_json_intern_compute_float(
+    const plain_json_FloatFormat *format, uint64_t w, int64_t q, bool is_truncated,
+    const uint8_t *text, uintptr_t text_length, int64_t exponent
+) {
+    plain_json_FloatBits result = plain_json_intern_eisel_lemire(format, q, w);
+
+    if (is_truncated) {
+        const plain_json_FloatBits upper = plain_json_intern_eisel_lemire(format, q, w + 1);
+
+        if (upper.mantissa != result.mantissa || upper.power2 != result.power2) {
+            plain_json_Decimal decimal;
+            plain_json_intern_decimal_init(&decimal, text, text_length, exponent);
+            result = plain_json_intern_decimal_to_float(format, &decimal);
+        }
+    }
+
+    return result;
+}
+
+/* Eight digits are checked and converted at once (SWAR), the first digit ends up in the lowest
+ * byte. See "Fast number parsing" by Lemire for the constants. */
+static inline uint64_t plain_json_intern_load_digits(const uint8_t *buffer) {
+    uint64_t value = 0;
+    plain_json_intern_memcpy(&value, buffer, sizeof(value));
+    #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+    #endif
+    return value;
+}
+
+static inline bool plain_json_intern_is_eight_digits(uint64_t value) {
+    /* Each byte is in ['0', '9'] if its upper nibble is 3 both before and after adding 6 */
+    return ((value & 0xF0F0F0F0F0F0F0F0) |
+            (((value + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+}
+
+static inline uint32_t plain_json_intern_parse_eight_digits(uint64_t value) {
+    value -= 0x3030303030303030;
+    /* Combine neighbouring digits into 2 digit, then 4 digit and finally the 8 digit value */
+    value = (value * 10) + (value >> 8);
+    value = (((value & 0x000000FF000000FF) * 0x000F424000000064) +
+             (((value >> 16) & 0x000000FF000000FF) * 0x0000271000000001)) >>
+            32;
+    return (uint32_t)value;
+}
+
+/* Append the digits starting at 'offset' to 'value' (which may wrap around). Returns the offset
+ * of the first non digit. */
+static inline uintptr_t plain_json_intern_read_digits(
+    const uint8_t *buffer, uintptr_t buffer_size, uintptr_t offset, uint64_t *value_ptr
+) {
+    uint64_t value = *value_ptr;
+
+    while (offset + 8 <= buffer_size) {
+        const uint64_t digits = plain_json_intern_load_digits(buffer + offset);
+        if (!plain_json_intern_is_eight_digits(digits)) {
+            break;
+        }
+
+        value = value * 100000000 + plain_json_intern_parse_eight_digits(digits);
+        offset += 8;
+    }
+
+    while (offset < buffer_size && is_digit(buffer[offset])) {
+        value = value * 10 + (uint64_t)(buffer[offset] - '0');
+        offset++;
+    }
+
+    (*value_ptr) = value;
+    return offset;
+}
+
+static inline plain_json_ErrorType
+plain_json_intern_read_number(plain_json_Context *context, plain_json_Token *token) {
+    const uint8_t *buffer = context->buffer + context->buffer_offset;
+    const uintptr_t buffer_size = context->buffer_size - context->buffer_offset;
+    uintptr_t offset = 0;
+
+    const bool is_negative = buffer[0] == '-';
+    if (is_negative) {
+        offset++;
+    }
+
+    /* '+' is only legal in the exponent */
+    if (offset >= buffer_size || !is_digit(buffer[offset])) {
+        return PLAIN_JSON_ERROR_NUMBER_INVALID_SIGN;
+    }
+
+    /* The significand may wrap around, it is only used if there are at most 19 digits */
+    const uintptr_t integer_start = offset;
+    uint64_t significand = 0;
+
+    if (buffer[offset] == '0') {
+        offset++;
+        if (offset < buffer_size && is_digit(buffer[offset])) {
+            return PLAIN_JSON_ERROR_NUMBER_LEADING_ZERO;
+        }
+    } else {
+        offset = plain_json_intern_read_digits(buffer, buffer_size, offset, &significand);
+    }
+
+    const uintptr_t integer_end = offset;
+    const uintptr_t integer_length = integer_end - integer_start;
+    uintptr_t fraction_length = 0;
+
+    if (offset < buffer_size && buffer[offset] == '.') {
+        offset++;
+
+        const uintptr_t fraction_start = offset;
+        offset = plain_json_intern_read_digits(buffer, buffer_size, offset, &significand);
+
+        fraction_length = offset - fraction_start;
+        if (fraction_length == 0) {
+            return PLAIN_JSON_ERROR_NUMBER_INVALID_DECIMAL;
+        }
+    }
+
+    const uintptr_t digits_end = offset;
+    bool has_exponent = false;
+    int64_t exponent = 0;
+
+    if (offset < buffer_size && (buffer[offset] == 'e' || buffer[offset] == 'E')) {
+        has_exponent = true;
+        offset++;
+
+        if (offset >= buffer_size) {
+            return PLAIN_JSON_ERROR_UNEXPECTED_EOF;
+        }
+
+        const bool exponent_is_negative = buffer[offset] == '-';
+        if (buffer[offset] == '-' || buffer[offset] == '+') {
+            offset++;
+        }
+
+        if (offset >= buffer_size || !is_digit(buffer[offset])) {
+            return PLAIN_JSON_ERROR_NUMBER_INVALID_EXPO;
+        }
+
+        while (offset < buffer_size && is_digit(buffer[offset])) {
+            /* Way beyond the range of any float, the exact value does not matter */
+            if (exponent < 0x10000000) {
+                exponent = exponent * 10 + (buffer[offset] - '0');
+            }
+            offset++;
+        }
+
+        if (exponent_is_negative) {
+            exponent = -exponent;
+        }
+    }
+
+    /* Report the more specific error for common mistakes, anything else is left to the caller */
+    if (offset < buffer_size) {
+        switch (buffer[offset]) {
+        case '+':
+        case '-':
+            return PLAIN_JSON_ERROR_NUMBER_INVALID_SIGN;
+        case '.':
+            return PLAIN_JSON_ERROR_NUMBER_INVALID_DECIMAL;
+        case 'e':
+        case 'E':
+            return PLAIN_JSON_ERROR_NUMBER_INVALID_EXPO;
+        default:
+            break;
+        }
+    }
+
+    if (fraction_length == 0 && !has_exponent) {
+        /* INT64_MAX has 19 digits, the magnitude of INT64_MIN is one larger */
+        if (integer_length > 19 || significand > (uint64_t)INT64_MAX + is_negative) {
+            return is_negative ? PLAIN_JSON_ERROR_NUMBER_UNDERFLOW
+                               : PLAIN_JSON_ERROR_NUMBER_OVERFLOW;
+        }
+
+        token->value.integer = is_negative ? 0 - significand : significand;
+    } else {
+        int64_t q = exponent - (int64_t)fraction_length;
+        bool is_truncated = false;
+
+        /* Leading zeros are not significant */
+        if (integer_length + fraction_length > 19) {
+            uintptr_t start = integer_start;
+            while (start < digits_end && (buffer[start] == '0' || buffer[start] == '.')) {
+                start++;
+            }
+
+            /* Minus the decimal point, unless it was skipped as well */
+            const uintptr_t digit_count = digits_end - start -
+                                          (fraction_length > 0 && start <= integer_end ? 1 : 0);
+
+            if (digit_count > 19) {
+                /* Keep the first 19 digits, the dropped ones move the exponent */
+                is_truncated = true;
+                significand = 0;
+
+                for (uint32_t taken = 0; taken < 19; start++) {
+                    if (buffer[start] != '.') {
+                        significand = significand * 10 + (uint64_t)(buffer[start] - '0');
+                        taken++;
+                    }
+                }
+
+                q += (int64_t)(digit_count - 19);
+            }
+        }
+
+    #ifdef PLAIN_JSON_OPTION_FLOAT32
+        const plain_json_FloatFormat *format = &plain_json_intern_float32_format;
+        static const float powers_of_ten[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f,
+                                               1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+        float value = 0;
+        uint32_t bits = 0;
+        const uint64_t max_exact = (uint64_t)1 << 24;
+        const int64_t max_exact_power = 10;
+        token->type = PLAIN_JSON_TYPE_FLOAT32;
+    #else
+        const plain_json_FloatFormat *format = &plain_json_intern_float64_format;
+        static const double powers_of_ten[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                                1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        double value = 0;
+        uint64_t bits = 0;
+        const uint64_t max_exact = (uint64_t)1 << 53;
+        const int64_t max_exact_power = 22;
+        token->type = PLAIN_JSON_TYPE_FLOAT64;
+    #endif
+
+        /* Clinger's fast path, a single correctly rounded operation on exact values. This is
+         * only true if floats are evaluated at their own precision (not the case with x87). */
+    #if !defined(__FLT_EVAL_METHOD__) || __FLT_EVAL_METHOD__ == 0
+        if (!is_truncated && significand <= max_exact && q >= -max_exact_power &&
+            q <= max_exact_power) {
+            value = significand;
+            value = q < 0 ? value / powers_of_ten[-q] : value * powers_of_ten[q];
+            value = is_negative ? -value : value;
+        } else
+    #endif
+        {
+            const plain_json_FloatBits result = plain_json_intern_compute_float(
+                format, significand, q, is_truncated, buffer + integer_start,
+                digits_end - integer_start, exponent
+            );
+
+            if (result.power2 == format->infinite_power) {
+                return is_negative ? PLAIN_JSON_ERROR_NUMBER_UNDERFLOW
+                                   : PLAIN_JSON_ERROR_NUMBER_OVERFLOW;
+            }
+
+            bits = result.mantissa | ((uint64_t)result.power2 << format->mantissa_bits);
+            if (is_negative) {
+                bits |= (uint64_t)1 << (sizeof(bits) * 8 - 1);
+            }
+            plain_json_intern_memcpy(&value, &bits, sizeof(value));
+        }
+
+    #ifdef PLAIN_JSON_OPTION_FLOAT32
+        token->value.float32 = value;
+    #else
+        token->value.float64 = value;
+    #endif
+    }
+
+    token->length = offset;
+    plain_json_intern_consume(context, offset);
+    return PLAIN_JSON_HAS_REMAINING;
+}
+
+/* Skip over the value at the current offset, for members that a field mask does not select.
+ * Scalars go through the usual readers and get the same checks as kept ones. Containers are
+ * only scanned for brackets and unescaped quotes (blocks are scanned as in
+ * "plain_json_intern_count_tokens()") until the matching bracket, so nothing else inside of
+ * them is validated besides the nesting depth. */
+static plain_json_ErrorType plain_json_intern_skip_value(plain_json_Context *context) {
+    const uintptr_t buffer_size = context->buffer_size;
+    const uintptr_t start = context->buffer_offset;
+    const uint8_t first_char = context->buffer[start];
+    const uint32_t depth = context->depth;
+
+    plain_json_Token token;
+    switch (first_char) {
+    case '{':
+    case '[':
+        break;
+    case '\"':
+        plain_json_intern_consume(context, 1);
+        return plain_json_intern_skip_string(context);
+    case 't':
+    case 'f':
+    case 'n':
+        return plain_json_intern_read_keyword(context, &token);
+    default:
+        return plain_json_intern_read_number(context, &token);
+    }
+
+    uint64_t prev_escaped = 0;
+    uint64_t prev_in_string = 0;
+    bool is_object = false;
+
+    uintptr_t block_offset = start - start % PLAIN_JSON_BLOCKSIZE;
+    uint64_t from_start = ~(uint64_t)0 << (start - block_offset);
+    for (; block_offset < buffer_size; block_offset += PLAIN_JSON_BLOCKSIZE) {
+        const plain_json_BlockMask *mask = plain_json_intern_get_block(context, block_offset);
+        const uintptr_t remaining = buffer_size - block_offset;
+        const uint64_t valid =
+            (remaining >= PLAIN_JSON_BLOCKSIZE ? ~(uint64_t)0 : ((uint64_t)1 << remaining) - 1) &
+            from_start;
+        from_start = ~(uint64_t)0;
+
+        const uint64_t escaped =
+            plain_json_intern_find_escaped(mask->backslash & valid, &prev_escaped);
+        const uint64_t quote = mask->quote & ~escaped & valid;
+        const uint64_t in_string = plain_json_intern_prefix_xor(quote) ^ prev_in_string;
+        prev_in_string = (uint64_t)((int64_t)in_string >> 63);
+
+        uint64_t structural = mask->structural & ~in_string & valid;
+        while (structural != 0) {
+            const uintptr_t offset = block_offset + plain_json_intern_ctz64(structural);
+            const uint8_t current_char = context->buffer[offset];
+            structural &= structural - 1;
+
+            if (current_char == '{' || current_char == '[') {
+                if (context->depth >= context->max_depth) {
+                    context->buffer_offset = offset;
+                    return PLAIN_JSON_ERROR_NESTING_TOO_DEEP;
+                }
+                if (!plain_json_intern_push_depth(context, current_char == '{')) {
+                    return PLAIN_JSON_ERROR_NO_MEMORY;
+                }
+                is_object = current_char == '{';
+            } else if (current_char == '}' || current_char == ']') {
+                if ((current_char == '}') != is_object) {
+                    context->buffer_offset = offset;
+                    return PLAIN_JSON_ERROR_ILLEGAL_CHAR;
+                }
+
+                is_object = plain_json_intern_pop_depth(context) == PLAIN_JSON_STATE_OBJECT_COMMA;
+                if (context->depth == depth) {
+                    context->buffer_offset = offset + 1;
+                    return PLAIN_JSON_HAS_REMAINING;
+                }
+            }
+        }
+    }
+
+    context->buffer_offset = buffer_size;
+    return PLAIN_JSON_ERROR_UNEXPECTED_EOF;
+}
+
+static const uint8_t plain_json_intern_char_class[256] = {
+    ['{'] = PLAIN_JSON_CLASS_OBJECT_START,
+    ['}'] = PLAIN_JSON_CLASS_OBJECT_END,
+    ['['] = PLAIN_JSON_CLASS_ARRAY_START,
+    [']'] = PLAIN_JSON_CLASS_ARRAY_END,
+    [','] = PLAIN_JSON_CLASS_COMMA,
+    [':'] = PLAIN_JSON_CLASS_COLON,
+    ['"'] = PLAIN_JSON_CLASS_QUOTE,
+    ['n'] = PLAIN_JSON_CLASS_KEYWORD,
+    ['t'] = PLAIN_JSON_CLASS_KEYWORD,
+    ['f'] = PLAIN_JSON_CLASS_KEYWORD,
+    ['0'] = PLAIN_JSON_CLASS_NUMBER,
+    ['1'] = PLAIN_JSON_CLASS_NUMBER,
+    ['2'] = PLAIN_JSON_CLASS_NUMBER,
+    ['3'] = PLAIN_JSON_CLASS_NUMBER,
+    ['4'] = PLAIN_JSON_CLASS_NUMBER,
+    ['5'] = PLAIN_JSON_CLASS_NUMBER,
+    ['6'] = PLAIN_JSON_CLASS_NUMBER,
+    ['7'] = PLAIN_JSON_CLASS_NUMBER,
+    ['8'] = PLAIN_JSON_CLASS_NUMBER,
+    ['9'] = PLAIN_JSON_CLASS_NUMBER,
+    /* Rejected by the number parser with a more specific error */
+    ['-'] = PLAIN_JSON_CLASS_NUMBER,
+    ['+'] = PLAIN_JSON_CLASS_NUMBER,
+};
+
+    #define transition(action, next_state) \
+        (PLAIN_JSON_ACTION_##action | (PLAIN_JSON_STATE_##next_state << 4))
+    #define ILLEGAL transition(ILLEGAL_CHAR, ROOT_START)
+
+/* The next state of value actions is the state of the current level after the value. Containers
+ * push a new level on top of that. Columns follow the order of the character classes. */
+static const uint8_t plain_json_intern_transitions[PLAIN_JSON_STATE_COUNT][PLAIN_JSON_CLASS_COUNT] = {
+    [PLAIN_JSON_STATE_ROOT_START] = {
+        ILLEGAL,
+        transition(OBJECT_START, ROOT_END),
+        ILLEGAL,
+        transition(ARRAY_START, ROOT_END),
+        ILLEGAL,
+        ILLEGAL,
+        ILLEGAL,
+        transition(STRING, ROOT_END),
+        transition(KEYWORD, ROOT_END),
+        transition(NUMBER, ROOT_END),
+    },
+    [PLAIN_JSON_STATE_ROOT_END] = {
+        ILLEGAL, ILLEGAL, ILLEGAL, ILLEGAL, ILLEGAL, ILLEGAL, ILLEGAL, ILLEGAL, ILLEGAL, ILLEGAL,
+    },
+    [PLAIN_JSON_STATE_OBJECT_START] = {
+        ILLEGAL,
+        ILLEGAL,
+        transition(OBJECT_END, ROOT_START),
+        ILLEGAL,
+        ILLEGAL,
+        ILLEGAL,
+        ILLEGAL,
+        transition(KEY, OBJECT_COLON),
+        ILLEGAL,
+        ILLEGAL,
+    },
+    [PLAIN_JSON_STATE_OBJECT_KEY] = {
+        ILLEGAL,
+        ILLEGAL,
+        transition(UNEXPECTED_COMMA, ROOT_START),
+        ILLEGAL,
+        ILLEGAL,
+        ILLEGAL,
+        ILLEGAL,
+        transition(KEY, OBJECT_COLON),
+        ILLEGAL,
+        ILLEGAL,
+    },
+    [PLAIN_JSON_STATE_OBJECT_COLON] = {
+        ILLEGAL,
+        ILLEGAL,
+        ILLEGAL,
+        ILLEGAL,
+        ILLEGAL,
+        ILLEGAL,
+        transition(COLON, OBJECT_VALUE),
+        ILLEGAL,
+        ILLEGAL,
+        ILLEGAL,
+    },
+    [PLAIN_JSON_STATE_OBJECT_VALUE] = {
+        ILLEGAL,
+        transition(OBJECT_START, OBJECT_COMMA),
+        ILLEGAL,
+        transition(ARRAY_START, OBJECT_COMMA),
+        ILLEGAL,
+        ILLEGAL,
+        ILLEGAL,
+        transition(STRING, OBJECT_COMMA),
+        transition(KEYWORD, OBJECT_COMMA),
+        transition(NUMBER, OBJECT_COMMA),
+    },
+    [PLAIN_JSON_STATE_OBJECT_COMMA] = {
+        ILLEGAL,
+        ILLEGAL,
+        transition(OBJECT_END, ROOT_START),
+        ILLEGAL,
+        ILLEGAL,
+        transition(COMMA, OBJECT_KEY),
+        ILLEGAL,
+        transition(MISSING_COMMA, ROOT_START),
+        ILLEGAL,
+        ILLEGAL,
+    },
+    [PLAIN_JSON_STATE_ARRAY_START] = {
+        ILLEGAL,
+        transition(OBJECT_START, ARRAY_COMMA),
+        ILLEGAL,
+        transition(ARRAY_START, ARRAY_COMMA),
+        transition(ARRAY_END, ROOT_START),
+        ILLEGAL,
+        ILLEGAL,
+        transition(STRING, ARRAY_COMMA),
+        transition(KEYWORD, ARRAY_COMMA),
+        transition(NUMBER, ARRAY_COMMA),
+    },
+    [PLAIN_JSON_STATE_ARRAY_VALUE] = {
+        ILLEGAL,
+        transition(OBJECT_START, ARRAY_COMMA),
+        ILLEGAL,
+        transition(ARRAY_START, ARRAY_COMMA),
+        transition(UNEXPECTED_COMMA, ROOT_START),
+        ILLEGAL,
+        ILLEGAL,
+        transition(STRING, ARRAY_COMMA),
+        transition(KEYWORD, ARRAY_COMMA),
+        transition(NUMBER, ARRAY_COMMA),
+    },
+    [PLAIN_JSON_STATE_ARRAY_COMMA] = {
+        ILLEGAL,
+        transition(MISSING_COMMA, ROOT_START),
+        ILLEGAL,
+        transition(MISSING_COMMA, ROOT_START),
+        transition(ARRAY_END, ROOT_START),
+        transition(COMMA, ARRAY_VALUE),
+        ILLEGAL,
+        transition(MISSING_COMMA, ROOT_START),
+        transition(MISSING_COMMA, ROOT_START),
+        transition(MISSING_COMMA, ROOT_START),
+    },
+};
+
+    #undef ILLEGAL
+
+    #define get_state()      context->state
+    #define set_state(value) (context->state = (value))
+
+    #ifdef PLAIN_JSON_COMPUTED_GOTO
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wpedantic"
+    #endif
+
+static plain_json_ErrorType
+plain_json_intern_read_token(plain_json_Context *context, plain_json_Token *token) {
+    #ifdef PLAIN_JSON_COMPUTED_GOTO
+    /* Same order as the action definitions */
+    static const void *const actions[] = {
+        &&illegal_char, &&missing_comma, &&unexpected_comma, &&object_start, &&object_end,
+        &&array_start,  &&array_end,     &&comma,            &&colon,        &&key,
+        &&string,       &&keyword,       &&number,
+    };
+    #endif
+
+    plain_json_ErrorType status = PLAIN_JSON_HAS_REMAINING;
+    uint32_t key_hash = 0;
+
+    while (plain_json_intern_skip_blanks(context)) {
+        const uint8_t current_char = plain_json_intern_peek(context, 0);
+        const uint8_t transition =
+            plain_json_intern_transitions[get_state()][plain_json_intern_char_class[current_char]];
+        const uint8_t next_state = transition >> 4;
+
+        token->start = context->buffer_offset;
+        token->length = 1;
+
+    #ifdef PLAIN_JSON_COMPUTED_GOTO
+        goto *actions[transition & 0x0F];
+    #else
+        switch (transition & 0x0F) {
+        case PLAIN_JSON_ACTION_ILLEGAL_CHAR:
+            goto illegal_char;
+        case PLAIN_JSON_ACTION_MISSING_COMMA:
+            goto missing_comma;
+        case PLAIN_JSON_ACTION_UNEXPECTED_COMMA:
+            goto unexpected_comma;
+        case PLAIN_JSON_ACTION_OBJECT_START:
+            goto object_start;
+        case PLAIN_JSON_ACTION_OBJECT_END:
+            goto object_end;
+        case PLAIN_JSON_ACTION_ARRAY_START:
+            goto array_start;
+        case PLAIN_JSON_ACTION_ARRAY_END:
+            goto array_end;
+        case PLAIN_JSON_ACTION_COMMA:
+            goto comma;
+        case PLAIN_JSON_ACTION_COLON:
+            goto colon;
+        case PLAIN_JSON_ACTION_KEY:
+            goto key;
+        case PLAIN_JSON_ACTION_STRING:
+            goto string;
+        case PLAIN_JSON_ACTION_KEYWORD:
+            goto keyword;
+        case PLAIN_JSON_ACTION_NUMBER:
+            goto number;
+        }
+    #endif
+
+    illegal_char:
+        status = PLAIN_JSON_ERROR_ILLEGAL_CHAR;
+        goto emit;
+
+    missing_comma:
+        status = PLAIN_JSON_ERROR_MISSING_COMMA;
+        goto emit;
+
+    unexpected_comma:
+        status = PLAIN_JSON_ERROR_UNEXPECTED_COMMA;
+        goto emit;
+
+    object_start:
+        token->type = PLAIN_JSON_TYPE_OBJECT_START;
+        goto push;
+
+    array_start:
+        token->type = PLAIN_JSON_TYPE_ARRAY_START;
+        goto push;
+
+    push:
+        if (context->depth >= context->max_depth) {
+            status = PLAIN_JSON_ERROR_NESTING_TOO_DEEP;
+            goto emit;
+        }
+
+        if (context->query != PLAIN_JSON_NULL) {
+            plain_json_intern_query_value(context, token->key_index);
+        }
+
+        /* The state after the container follows from its parent, see "pop" */
+        if (!plain_json_intern_push_depth(context, token->type == PLAIN_JSON_TYPE_OBJECT_START)) {
+            status = PLAIN_JSON_ERROR_NO_MEMORY;
+            goto emit;
+        }
+
+        if (context->query != PLAIN_JSON_NULL && !plain_json_intern_query_push(context)) {
+            status = PLAIN_JSON_ERROR_NO_MEMORY;
+            goto emit;
+        }
+
+        if (context->mask != PLAIN_JSON_NULL && !plain_json_intern_mask_push(context)) {
+            status = PLAIN_JSON_ERROR_NO_MEMORY;
+            goto emit;
+        }
+
+        set_state(
+            token->type == PLAIN_JSON_TYPE_OBJECT_START ? PLAIN_JSON_STATE_OBJECT_START
+                                                        : PLAIN_JSON_STATE_ARRAY_START
+        );
+
+        plain_json_intern_consume(context, 1);
+        goto emit;
+
+    object_end:
+        token->type = PLAIN_JSON_TYPE_OBJECT_END;
+        goto pop;
+
+    array_end:
+        token->type = PLAIN_JSON_TYPE_ARRAY_END;
+        goto pop;
+
+    pop:
+        /* The closing states only exist in nested levels */
+        json_assert(context->depth > 0);
+        set_state(plain_json_intern_pop_depth(context));
+
+        if (context->mask != PLAIN_JSON_NULL && context->depth > 0) {
+            context->mask_node =
+                *(const uint32_t *)plain_json_list_get(&context->mask_levels, context->depth - 1);
+            context->mask_value = context->mask_node;
+        }
+
+        plain_json_intern_consume(context, 1);
+        goto emit;
+
+    comma:
+        set_state(next_state);
+        plain_json_intern_consume(context, 1);
+        continue;
+
+    colon:
+        set_state(next_state);
+        plain_json_intern_consume(context, 1);
+
+        /* The value of a member that the mask does not select is skipped as a whole. Anything
+         * but a value is left to the next iteration, to report the error. */
+        if (context->mask_value == PLAIN_JSON_NO_KEY && plain_json_intern_skip_blanks(context)) {
+            const uint8_t value_class =
+                plain_json_intern_char_class[plain_json_intern_peek(context, 0)];
+            if (plain_json_intern_transitions[get_state()][value_class] >> 4 ==
+                PLAIN_JSON_STATE_OBJECT_COMMA) {
+                status = plain_json_intern_skip_value(context);
+                if (status != PLAIN_JSON_HAS_REMAINING) {
+                    goto emit;
+                }
+
+                set_state(PLAIN_JSON_STATE_OBJECT_COMMA);
+                context->mask_value = context->mask_node;
+            }
+        }
+        continue;
+
+    key:
+        set_state(next_state);
+        plain_json_intern_consume(context, 1);
+
+        /* Keys below a container that a query can not select are never looked at */
+        if (context->query_dead_depth != 0) {
+            status = plain_json_intern_skip_string(context);
+            if (status != PLAIN_JSON_HAS_REMAINING) {
+                goto emit;
+            }
+            continue;
+        }
+
+        if (!plain_json_intern_list_append(
+                &context->string_buffer, &context->alloc_config, &key_hash, sizeof(key_hash)
+            )) {
+            status = PLAIN_JSON_ERROR_NO_MEMORY;
+            goto emit;
+        }
+
+        token->key_index = context->string_buffer.item_count;
+        status = plain_json_intern_read_string(context);
+        if (status != PLAIN_JSON_HAS_REMAINING) {
+            goto emit;
+        }
+
+        key_hash = plain_json_intern_store_key_hash(context, token->key_index);
+        if (context->mask != PLAIN_JSON_NULL) {
+            context->mask_value =
+                plain_json_intern_mask_member(context, token->key_index, key_hash);
+            if (context->mask_value == PLAIN_JSON_NO_KEY) {
+                /* Dropped with its value, see "colon" */
+                context->string_buffer.item_count = token->key_index - sizeof(key_hash);
+                token->key_index = PLAIN_JSON_NO_KEY;
+                continue;
+            }
+        }
+
+        if ((context->flags & PLAIN_JSON_FLAG_INTERN_KEYS) &&
+            !plain_json_intern_dedup_key(context, &token->key_index, key_hash)) {
+            status = PLAIN_JSON_ERROR_NO_MEMORY;
+            goto emit;
+        }
+        continue;
+
+    string:
+        set_state(next_state);
+        plain_json_intern_consume(context, 1);
+
+        token->start = context->buffer_offset;
+        token->type = PLAIN_JSON_TYPE_STRING;
+        token->value.string_index = context->string_buffer.item_count;
+
+        if (context->query != PLAIN_JSON_NULL) {
+            plain_json_intern_query_value(context, token->key_index);
+            if (!context->query_keep) {
+                status = plain_json_intern_skip_string(context);
+                goto emit;
+            }
+        }
+
+        status = plain_json_intern_read_string(context);
+        goto emit;
+
+    keyword:
+        set_state(next_state);
+        if (context->query != PLAIN_JSON_NULL) {
+            plain_json_intern_query_value(context, token->key_index);
+        }
+
+        status = plain_json_intern_read_keyword(context, token);
+        goto emit;
+
+    number:
+        set_state(next_state);
+        if (context->query != PLAIN_JSON_NULL) {
+            plain_json_intern_query_value(context, token->key_index);
+        }
+
+        token->type = PLAIN_JSON_TYPE_INTEGER;
+        status = plain_json_intern_read_number(context, token);
+        goto emit;
+
+    emit:
+        if (status != PLAIN_JSON_HAS_REMAINING) {
+            token->type = PLAIN_JSON_TYPE_ERROR;
+            token->start = context->buffer_offset;
+            token->value.string_index = 0;
+        }
+
+        return status;
+    }
+
+    if (get_state() == PLAIN_JSON_STATE_ROOT_END) {
+        return PLAIN_JSON_DONE;
+    }
+
+    return PLAIN_JSON_ERROR_UNEXPECTED_EOF;
+}
+
+    #ifdef PLAIN_JSON_COMPUTED_GOTO
+        #pragma GCC diagnostic pop
+    #endif
+
+static bool plain_json_intern_append_token(plain_json_Context *context, const plain_json_Token *token) {
+    if (!(context->flags & PLAIN_JSON_FLAG_COMPACT_TOKENS)) {
+        return plain_json_intern_list_append(&context->token_buffer, &context->alloc_config, token, 1);
+    }
+
+    plain_json_CompactToken compact = { 0 };
+    compact.value = token->value;
+    compact.key_index = token->key_index;
+    compact.type = (uint8_t)token->type;
+    if (token->type == PLAIN_JSON_TYPE_ERROR) {
+        compact.value.integer = token->start;
+    }
+
+    return plain_json_intern_list_append(&context->token_buffer, &context->alloc_config, &compact, 1);
+}
+
+static inline plain_json_Value *
+plain_json_intern_get_value(plain_json_Context *context, uint32_t index) {
+    const uintptr_t offset = (uintptr_t)context->token_buffer.item_size * index;
+    uint8_t *entry = context->token_buffer.buffer + offset;
+    if (context->flags & PLAIN_JSON_FLAG_COMPACT_TOKENS) {
+        return &((plain_json_CompactToken *)entry)->value;
+    }
+
+    return &((plain_json_Token *)entry)->value;
+}
+
+/* Link the start token of a container to its end token and count its children, as tokens are
+ * appended. While the container is open, its start token holds the enclosing container instead
+ * of its end, so the token buffer doubles as the stack. */
+static inline void plain_json_intern_link_token(plain_json_Context *context, plain_json_Type type) {
+    const uint32_t index = context->token_buffer.item_count - 1;
+
+    if (type == PLAIN_JSON_TYPE_ERROR) {
+        return;
+    }
+
+    if (type == PLAIN_JSON_TYPE_OBJECT_END || type == PLAIN_JSON_TYPE_ARRAY_END) {
+        plain_json_Value *end = plain_json_intern_get_value(context, index);
+        if (context->depth < context->drained_depth) {
+            context->drained_depth = context->depth;
+            end->container_end.parent_index = PLAIN_JSON_NO_KEY;
+            return;
+        }
+
+        plain_json_Value *start = plain_json_intern_get_value(context, context->container);
+        context->container = start->container.end_index;
+        start->container.end_index = index;
+        end->container_end.parent_index = context->container;
+        return;
+    }
+
+    /* Any other token is a member or element of the innermost container */
+    if (context->container != PLAIN_JSON_NO_KEY) {
+        plain_json_intern_get_value(context, context->container)->container.child_count++;
+    }
+
+    if (type == PLAIN_JSON_TYPE_OBJECT_START || type == PLAIN_JSON_TYPE_ARRAY_START) {
+        plain_json_intern_get_value(context, index)->container.end_index = context->container;
+        context->container = index;
+    }
+}
+
+/* Read tokens until the end of the document (or an error). With fixed buffers, a token that
+ * does not fit is rolled back, so "plain_json_resume()" can read it again. */
+static plain_json_ErrorType plain_json_intern_parse_tokens(plain_json_Context *context) {
+    /* Strings parsed in situ must not be decoded twice, so a token that might not fit is not
+     * read at all. It reads at most two strings (its key, with its hash, and value). */
+    const bool in_situ = context->fixed && context->in_situ;
+    const uintptr_t in_situ_size = 3 * sizeof(uint32_t) + 2 * sizeof(uintptr_t);
+    plain_json_List *token_buffer = &context->token_buffer;
+
+    plain_json_ErrorType status = PLAIN_JSON_HAS_REMAINING;
+    while (status == PLAIN_JSON_HAS_REMAINING) {
+        const uintptr_t buffer_offset = context->buffer_offset;
+        const uint32_t string_count = context->string_buffer.item_count;
+        const uint32_t depth = context->depth;
+        const uint8_t state = context->state;
+
+        plain_json_Token token = { 0 };
+
+        token.type = PLAIN_JSON_TYPE_INVALID;
+        token.key_index = PLAIN_JSON_NO_KEY;
+        token.value.float64 = 0;
+
+        if (in_situ &&
+            (string_count + in_situ_size > context->string_buffer.alloc_size ||
+             ((uintptr_t)token_buffer->item_count + 1) * token_buffer->item_size >
+                 token_buffer->alloc_size)) {
+            status = PLAIN_JSON_ERROR_NO_MEMORY;
+        } else {
+            status = plain_json_intern_read_token(context, &token);
+        }
+
+        bool fits = status != PLAIN_JSON_ERROR_NO_MEMORY || !context->fixed;
+        if (status == PLAIN_JSON_HAS_REMAINING && context->query != PLAIN_JSON_NULL &&
+            !plain_json_intern_query_keep(context, token.type)) {
+            /* Drop the key of a value that was not selected */
+            if ((context->flags & PLAIN_JSON_FLAG_INTERN_KEYS) &&
+                token.key_index != PLAIN_JSON_NO_KEY && token.key_index > string_count) {
+                plain_json_intern_drop_key(context, token.key_index);
+            }
+            context->string_buffer.item_count = string_count;
+        } else if (fits && status != PLAIN_JSON_DONE) {
+            fits = plain_json_intern_append_token(context, &token);
+            if (fits) {
+                plain_json_intern_link_token(context, token.type);
+            }
+        }
+
+        if (!fits) {
+            if (!context->fixed) {
+                return PLAIN_JSON_ERROR_NO_MEMORY;
+            }
+
+            context->buffer_offset = buffer_offset;
+            context->string_buffer.item_count = string_count;
+            context->depth = depth;
+            context->state = state;
+
+            /* The token would not fit, even after draining the buffers */
+            if (string_count == 0 && token_buffer->item_count == 0) {
+                return PLAIN_JSON_ERROR_NO_MEMORY;
+            }
+
+            return PLAIN_JSON_BUFFER_FULL;
+        }
+    }
+
+    return status;
+}
+
+plain_json_Context *plain_json_parse(
+    plain_json_AllocatorConfig alloc_config, const uint8_t *buffer, uintptr_t buffer_size,
+    plain_json_ErrorType *error
+) {
+    const plain_json_Options options = { 0 };
+    return plain_json_parse_with_options(alloc_config, options, buffer, buffer_size, error);
+}
+
+plain_json_Context *plain_json_parse_with_options(
+    plain_json_AllocatorConfig alloc_config, plain_json_Options options, const uint8_t *buffer,
+    uintptr_t buffer_size, plain_json_ErrorType *error
+) {
+    plain_json_Context *context = plain_json_create(alloc_config);
+    if (context == PLAIN_JSON_NULL) {
+        (*error) = PLAIN_JSON_ERROR_NO_MEMORY;
+        return PLAIN_JSON_NULL;
+    }
+
+    (*error) = plain_json_parse_into(context, options, buffer, buffer_size);
+    return context;
+}
+
+plain_json_Context *plain_json_create(plain_json_AllocatorConfig alloc_config) {
+    plain_json_Context *context = alloc_config.alloc_func(alloc_config.context, sizeof(*context));
+    if (context == PLAIN_JSON_NULL) {
+        return PLAIN_JSON_NULL;
+    }
+
+    plain_json_intern_memset(context, 0, sizeof(*context));
+
+    context->alloc_config = alloc_config;
+    context->string_buffer.page_size = PLAIN_JSON_STRING_PAGESIZE;
+    context->string_buffer.item_size = 1;
+    context->token_buffer.page_size = PLAIN_JSON_TOKEN_PAGESIZE;
+    context->token_buffer.item_size = sizeof(plain_json_Token);
+    context->query_levels.page_size = PLAIN_JSON_TOKEN_PAGESIZE;
+    context->query_levels.item_size = sizeof(plain_json_QueryLevel);
+    context->mask_levels.page_size = PLAIN_JSON_TOKEN_PAGESIZE;
+    context->mask_levels.item_size = sizeof(uint32_t);
+
+    plain_json_intern_select_simd(context);
+    plain_json_reset(context);
+
+    return context;
+}
+
+void plain_json_reset(plain_json_Context *context) {
+    context->buffer = PLAIN_JSON_NULL;
+    context->buffer_size = 0;
+    context->buffer_offset = 0;
+    context->block_offset = UINTPTR_MAX;
+
+    context->state = PLAIN_JSON_STATE_ROOT_START;
+    context->depth = 0;
+    context->max_depth = PLAIN_JSON_OPTION_MAX_DEPTH;
+    context->container = PLAIN_JSON_NO_KEY;
+    context->drained_depth = 0;
+
+    context->query = PLAIN_JSON_NULL;
+    context->query_emit_depth = 0;
+    context->query_dead_depth = 0;
+    context->query_levels.item_count = 0;
+
+    context->mask = PLAIN_JSON_NULL;
+    context->mask_node = 0;
+    context->mask_value = 0;
+    context->mask_levels.item_count = 0;
+
+    /* Keep the allocations around for the next document */
+    context->string_buffer.item_count = 0;
+    context->token_buffer.item_count = 0;
+
+    if (context->key_count > 0) {
+        plain_json_intern_memset(
+            context->key_slots, 0xFF, context->key_slot_count * sizeof(*context->key_slots)
+        );
+        context->key_count = 0;
+    }
+
+    plain_json_intern_clear_members(context);
+}
+
+static plain_json_ErrorType plain_json_intern_parse_into(
+    plain_json_Context *context, plain_json_Options options, const uint8_t *buffer,
+    uintptr_t buffer_size, bool in_situ
+) {
+    plain_json_reset(context);
+
+    context->buffer = (uint8_t *)buffer;
+    context->buffer_size = buffer_size;
+    context->flags = options.flags;
+    context->in_situ = in_situ;
+    if (options.max_depth != 0) {
+        context->max_depth = options.max_depth;
+    }
+    context->query = options.query;
+    context->mask = options.mask;
+    context->token_buffer.item_size = (options.flags & PLAIN_JSON_FLAG_COMPACT_TOKENS)
+                                         ? sizeof(plain_json_CompactToken)
+                                         : sizeof(plain_json_Token);
+
+    if (context->fixed) {
+        /* The query and mask levels would have to be allocated */
+        if (options.query != PLAIN_JSON_NULL) {
+            return PLAIN_JSON_ERROR_QUERY_INVALID;
+        }
+        if (options.mask != PLAIN_JSON_NULL) {
+            return PLAIN_JSON_ERROR_MASK_INVALID;
+        }
+
+        context->flags &= ~(PLAIN_JSON_FLAG_EXACT_SIZE | PLAIN_JSON_FLAG_INTERN_KEYS);
+        if (context->max_depth > PLAIN_JSON_DEPTH_INLINE * 64) {
+            context->max_depth = PLAIN_JSON_DEPTH_INLINE * 64;
+        }
+        return plain_json_intern_parse_tokens(context);
+    }
+
+    uintptr_t token_count = options.token_count_hint;
+    uintptr_t string_size = options.string_size_hint;
+    if (options.flags & PLAIN_JSON_FLAG_EXACT_SIZE) {
+        plain_json_intern_count_tokens(context, &token_count, &string_size);
+    }
+
+    if (!plain_json_intern_list_reserve(
+            &context->token_buffer, &context->alloc_config, token_count
+        ) ||
+        !plain_json_intern_list_reserve(
+            &context->string_buffer, &context->alloc_config, string_size
+        )) {
+        return PLAIN_JSON_ERROR_NO_MEMORY;
+    }
+
+    return plain_json_intern_parse_tokens(context);
+}
+
+plain_json_ErrorType plain_json_parse_in_situ(
+    plain_json_Context *context, plain_json_Options options, uint8_t *buffer, uintptr_t buffer_size
+) {
+    return plain_json_intern_parse_into(context, options, buffer, buffer_size, true);
+}
+
+plain_json_ErrorType plain_json_parse_into(
+    plain_json_Context *context, plain_json_Options options, const uint8_t *buffer,
+    uintptr_t buffer_size
+) {
+    return plain_json_intern_parse_into(context, options, buffer, buffer_size, false);
+}
+
+plain_json_ErrorType plain_json_resume(plain_json_Context *context) {
+    context->string_buffer.item_count = 0;
+    context->token_buffer.item_count = 0;
+    context->container = PLAIN_JSON_NO_KEY;
+    context->drained_depth = context->depth;
+    plain_json_intern_clear_members(context);
+
+    return plain_json_intern_parse_tokens(context);
+}
+
+static void *plain_json_intern_fixed_alloc(void *context, uintptr_t size) {
+    (void)context;
+    (void)size;
+    return PLAIN_JSON_NULL;
+}
+
+static void *
+plain_json_intern_fixed_realloc(void *context, void *buffer, uintptr_t old_size, uintptr_t new_size) {
+    (void)context;
+    (void)buffer;
+    (void)old_size;
+    (void)new_size;
+    return PLAIN_JSON_NULL;
+}
+
+static void plain_json_intern_fixed_free(void *context, void *buffer) {
+    (void)context;
+    (void)buffer;
+}
+
+uintptr_t plain_json_context_size(void) {
+    return sizeof(plain_json_Context);
+}
+
+plain_json_Context *plain_json_create_fixed(
+    void *memory, uintptr_t memory_size, void *token_buffer, uintptr_t token_buffer_size,
+    void *string_buffer, uintptr_t string_buffer_size
+) {
+    const uintptr_t padding = plain_json_intern_align((uintptr_t)memory) - (uintptr_t)memory;
+    if (memory == PLAIN_JSON_NULL || memory_size < padding + sizeof(plain_json_Context)) {
+        return PLAIN_JSON_NULL;
+    }
+
+    plain_json_AllocatorConfig alloc_config = {
+        .alloc_func = plain_json_intern_fixed_alloc,
+        .realloc_func = plain_json_intern_fixed_realloc,
+        .free_func = plain_json_intern_fixed_free,
+    };
+
+    plain_json_Context *context = (plain_json_Context *)((uint8_t *)memory + padding);
+    plain_json_intern_memset(context, 0, sizeof(*context));
+
+    context->fixed = true;
+    context->alloc_config = alloc_config;
+    context->string_buffer.page_size = PLAIN_JSON_STRING_PAGESIZE;
+    context->string_buffer.item_size = 1;
+    context->token_buffer.page_size = PLAIN_JSON_TOKEN_PAGESIZE;
+    context->token_buffer.item_size = sizeof(plain_json_Token);
+
+    /* Tokens hold 8 byte values */
+    const uintptr_t token_padding =
+        plain_json_intern_align((uintptr_t)token_buffer) - (uintptr_t)token_buffer;
+    if (token_buffer != PLAIN_JSON_NULL && token_buffer_size > token_padding) {
+        context->token_buffer.buffer = (uint8_t *)token_buffer + token_padding;
+        context->token_buffer.alloc_size = token_buffer_size - token_padding;
+    }
+
+    context->string_buffer.buffer = string_buffer;
+    context->string_buffer.alloc_size = string_buffer != PLAIN_JSON_NULL ? string_buffer_size : 0;
+
+    plain_json_intern_select_simd(context);
+    plain_json_reset(context);
+
+    return context;
+}
+
+void plain_json_free(plain_json_Context *context) {
+    if (context == PLAIN_JSON_NULL || context->fixed) {
+        return;
+    }
+
+    plain_json_AllocatorConfig config = context->alloc_config;
+    if (context->token_buffer.buffer != PLAIN_JSON_NULL) {
+        config.free_func(config.context, context->token_buffer.buffer);
+        context->token_buffer.buffer = PLAIN_JSON_NULL;
+    }
+    if (context->string_buffer.buffer != PLAIN_JSON_NULL) {
+        config.free_func(config.context, context->string_buffer.buffer);
+        context->string_buffer.buffer = PLAIN_JSON_NULL;
+    }
+    if (context->key_slots != PLAIN_JSON_NULL) {
+        config.free_func(config.context, context->key_slots);
+        context->key_slots = PLAIN_JSON_NULL;
+    }
+    if (context->depth_spill != PLAIN_JSON_NULL) {
+        config.free_func(config.context, context->depth_spill);
+        context->depth_spill = PLAIN_JSON_NULL;
+    }
+    if (context->member_slots != PLAIN_JSON_NULL) {
+        config.free_func(config.context, context->member_slots);
+        context->member_slots = PLAIN_JSON_NULL;
+    }
+    if (context->query_levels.buffer != PLAIN_JSON_NULL) {
+        config.free_func(config.context, context->query_levels.buffer);
+        context->query_levels.buffer = PLAIN_JSON_NULL;
+    }
+    if (context->mask_levels.buffer != PLAIN_JSON_NULL) {
+        config.free_func(config.context, context->mask_levels.buffer);
+        context->mask_levels.buffer = PLAIN_JSON_NULL;
+    }
+
+    config.free_func(config.context, context);
+}
+
+void plain_json_arena_init(
+    plain_json_Arena *arena, void *buffer, uintptr_t buffer_size,
+    const plain_json_AllocatorConfig *backing
+) {
+    plain_json_intern_memset(arena, 0, sizeof(*arena));
+
+    /* Start on an aligned address, so every allocation is aligned */
+    const uintptr_t padding = plain_json_intern_align((uintptr_t)buffer) - (uintptr_t)buffer;
+    if (buffer != PLAIN_JSON_NULL && buffer_size > padding) {
+        arena->initial_buffer = (uint8_t *)buffer + padding;
+        arena->initial_size = buffer_size - padding;
+    }
+
+    if (backing != PLAIN_JSON_NULL) {
+        arena->has_backing = true;
+        arena->backing = *backing;
+    }
+
+    arena->buffer = arena->initial_buffer;
+    arena->buffer_size = arena->initial_size;
+}
+
+plain_json_AllocatorConfig plain_json_arena_allocator(plain_json_Arena *arena) {
+    plain_json_AllocatorConfig config = {
+        .context = arena,
+        .alloc_func = plain_json_intern_arena_alloc,
+        .realloc_func = plain_json_intern_arena_realloc,
+        .free_func = plain_json_intern_arena_free,
+    };
+
+    return config;
+}
+
+void plain_json_arena_reset(plain_json_Arena *arena) {
+    plain_json_ArenaChunk *chunk = arena->chunks;
+
+    /* Keep the largest (most recent) chunk as a spare behind the caller provided buffer, so
+     * the buffer stays the first allocation of every document. */
+    if (chunk != PLAIN_JSON_NULL) {
+        while (chunk->prev != PLAIN_JSON_NULL) {
+            plain_json_ArenaChunk *prev = chunk->prev;
+            chunk->prev = prev->prev;
+            arena->backing.free_func(arena->backing.context, prev);
+        }
+
+        arena->chunks = PLAIN_JSON_NULL;
+        arena->spare = chunk;
+    }
+
+    arena->buffer = arena->initial_buffer;
+    arena->buffer_size = arena->initial_size;
+    arena->offset = 0;
+    arena->last_offset = 0;
+}
+
+void plain_json_arena_release(plain_json_Arena *arena) {
+    while (arena->chunks != PLAIN_JSON_NULL) {
+        plain_json_ArenaChunk *prev = arena->chunks->prev;
+        arena->backing.free_func(arena->backing.context, arena->chunks);
+        arena->chunks = prev;
+    }
+
+    if (arena->spare != PLAIN_JSON_NULL) {
+        arena->backing.free_func(arena->backing.context, arena->spare);
+        arena->spare = PLAIN_JSON_NULL;
+    }
+
+    arena->buffer = arena->initial_buffer;
+    arena->buffer_size = arena->initial_size;
+    arena->offset = 0;
+    arena->last_offset = 0;
+}
+
+const uint8_t *plain_json_get_key(plain_json_Context *context, uint32_t key_index) {
+    return plain_json_intern_get_entry(context, key_index).data;
+}
+
+const uint8_t *plain_json_get_string(plain_json_Context *context, uint32_t string_index) {
+    return plain_json_intern_get_entry(context, string_index).data;
+}
+
+uint32_t plain_json_get_string_length(plain_json_Context *context, uint32_t string_index) {
+    return plain_json_intern_get_entry(context, string_index).length;
+}
+
+plain_json_String plain_json_get_key_view(plain_json_Context *context, uint32_t key_index) {
+    return plain_json_intern_get_entry(context, key_index);
+}
+
+plain_json_String plain_json_get_string_view(plain_json_Context *context, uint32_t string_index) {
+    return plain_json_intern_get_entry(context, string_index);
+}
+
+bool plain_json_key_equals(
+    plain_json_Context *context, uint32_t key_index, const uint8_t *key, uint32_t length
+) {
+    const plain_json_String entry = plain_json_intern_get_entry(context, key_index);
+
+    return entry.data != PLAIN_JSON_NULL && entry.length == length &&
+           plain_json_intern_memcmp(entry.data, key, length) == 0;
+}
+
+uint32_t plain_json_get_key_hash(plain_json_Context *context, uint32_t key_index) {
+    uint32_t hash = 0;
+    if (key_index < sizeof(hash) || key_index >= context->string_buffer.item_count) {
+        return 0;
+    }
+
+    plain_json_intern_memcpy(
+        &hash, context->string_buffer.buffer + key_index - sizeof(hash), sizeof(hash)
+    );
+    return hash;
+}
+
+uint32_t plain_json_hash(const uint8_t *key, uint32_t length) {
+    return plain_json_intern_hash(key, length);
+}
+
+const plain_json_Token *plain_json_get_token(plain_json_Context *context, uint32_t index) {
+    const uint8_t *entry = plain_json_list_get(&context->token_buffer, index);
+    if (entry == PLAIN_JSON_NULL || !(context->flags & PLAIN_JSON_FLAG_COMPACT_TOKENS)) {
+        return (const plain_json_Token *)entry;
+    }
+
+    const plain_json_CompactToken *compact = (const plain_json_CompactToken *)entry;
+    plain_json_Token *token = &context->expanded_token;
+
+    token->start = 0;
+    token->length = 0;
+    token->key_index = compact->key_index;
+    token->type = (plain_json_Type)compact->type;
+    token->value = compact->value;
+    if (token->type == PLAIN_JSON_TYPE_ERROR) {
+        token->start = (uintptr_t)compact->value.integer;
+        token->value.string_index = 0;
+    }
+
+    return token;
+}
+
+plain_json_Type plain_json_get_type(plain_json_Context *context, uint32_t index) {
+    const uint8_t *entry = plain_json_list_get(&context->token_buffer, index);
+    if (entry == PLAIN_JSON_NULL) {
+        return PLAIN_JSON_TYPE_INVALID;
+    }
+
+    if (context->flags & PLAIN_JSON_FLAG_COMPACT_TOKENS) {
+        return (plain_json_Type)((const plain_json_CompactToken *)entry)->type;
+    }
+
+    return ((const plain_json_Token *)entry)->type;
+}
+
+uint32_t plain_json_get_token_count(plain_json_Context *context) {
+    return context->token_buffer.item_count;
+}
+
+/* Get the end token of a closed container, given its start token. Returns PLAIN_JSON_NO_KEY
+ * for containers that are still open, since they point to their parent (or nowhere). */
+static uint32_t plain_json_intern_get_end(plain_json_Context *context, uint32_t index) {
+    const uint32_t end_index = plain_json_intern_get_value(context, index)->container.end_index;
+    if (end_index == PLAIN_JSON_NO_KEY || end_index <= index) {
+        return PLAIN_JSON_NO_KEY;
+    }
+
+    return end_index;
+}
+
+uint32_t plain_json_skip(plain_json_Context *context, uint32_t index) {
+    const uint32_t count = context->token_buffer.item_count;
+    const plain_json_Type type = plain_json_get_type(context, index);
+    if (type != PLAIN_JSON_TYPE_OBJECT_START && type != PLAIN_JSON_TYPE_ARRAY_START) {
+        return index < count ? index + 1 : count;
+    }
+
+    const uint32_t end_index = plain_json_intern_get_end(context, index);
+    return end_index != PLAIN_JSON_NO_KEY ? end_index + 1 : count;
+}
+
+static inline uint32_t
+plain_json_intern_get_key_index(plain_json_Context *context, uint32_t index) {
+    const uint8_t *entry = plain_json_list_get(&context->token_buffer, index);
+    if (context->flags & PLAIN_JSON_FLAG_COMPACT_TOKENS) {
+        return ((const plain_json_CompactToken *)entry)->key_index;
+    }
+
+    return ((const plain_json_Token *)entry)->key_index;
+}
+
+/* Members of all indexed objects share one table, so the object is mixed into the position */
+static inline uint32_t plain_json_intern_member_position(uint32_t hash, uint32_t object) {
+    return hash ^ (object * 0x9E3779B1);
+}
+
+static bool plain_json_intern_grow_member_table(plain_json_Context *context) {
+    const uint32_t old_count = context->member_slot_count;
+    const uint32_t new_count = old_count != 0 ? old_count * 2 : PLAIN_JSON_MEMBER_TABLE_SIZE;
+    plain_json_AllocatorConfig *config = &context->alloc_config;
+
+    plain_json_MemberSlot *slots = config->alloc_func(config->context, new_count * sizeof(*slots));
+    if (slots == PLAIN_JSON_NULL) {
+        return false;
+    }
+
+    plain_json_intern_memset(slots, 0xFF, new_count * sizeof(*slots));
+    for (uint32_t i = 0; i < old_count; i++) {
+        const plain_json_MemberSlot slot = context->member_slots[i];
+        if (slot.member == PLAIN_JSON_NO_KEY) {
+            continue;
+        }
+
+        uint32_t position =
+            plain_json_intern_member_position(slot.hash, slot.object) & (new_count - 1);
+        while (slots[position].member != PLAIN_JSON_NO_KEY) {
+            position = (position + 1) & (new_count - 1);
+        }
+        slots[position] = slot;
+    }
+
+    if (context->member_slots != PLAIN_JSON_NULL) {
+        config->free_func(config->context, context->member_slots);
+    }
+
+    context->member_slots = slots;
+    context->member_slot_count = new_count;
+    return true;
+}
+
+/* Find the slot of a member, or the empty slot it would be inserted into */
+static plain_json_MemberSlot *plain_json_intern_find_member(
+    plain_json_Context *context, uint32_t object, uint32_t hash, const uint8_t *key, uint32_t length
+) {
+    const uint32_t mask = context->member_slot_count - 1;
+
+    uint32_t position = plain_json_intern_member_position(hash, object) & mask;
+    while (context->member_slots[position].member != PLAIN_JSON_NO_KEY) {
+        plain_json_MemberSlot *slot = &context->member_slots[position];
+
+        if (slot->object == object && slot->hash == hash && slot->member != object) {
+            const uint32_t key_index = plain_json_intern_get_key_index(context, slot->member);
+            if (plain_json_key_equals(context, key_index, key, length)) {
+                return slot;
+            }
+        }
+
+        position = (position + 1) & mask;
+    }
+
+    return &context->member_slots[position];
+}
+
+/* Find the marker slot of an indexed object, or the empty slot it would be inserted into */
+static plain_json_MemberSlot *
+plain_json_intern_find_marker(plain_json_Context *context, uint32_t object) {
+    const uint32_t mask = context->member_slot_count - 1;
+
+    uint32_t position = plain_json_intern_member_position(0, object) & mask;
+    while (context->member_slots[position].member != PLAIN_JSON_NO_KEY) {
+        plain_json_MemberSlot *slot = &context->member_slots[position];
+        if (slot->object == object && slot->member == object) {
+            return slot;
+        }
+
+        position = (position + 1) & mask;
+    }
+
+    return &context->member_slots[position];
+}
+
+/* Add all members of an object to the member table, unless that already happened */
+static bool plain_json_intern_index_object(
+    plain_json_Context *context, uint32_t object, uint32_t end, uint32_t member_count
+) {
+    if (context->member_slot_count > 0 &&
+        plain_json_intern_find_marker(context, object)->member == object) {
+        return true;
+    }
+
+    /* Keep the load factor at or below 1/2 */
+    while ((context->member_count + member_count + 1) * 2 > context->member_slot_count) {
+        if (!plain_json_intern_grow_member_table(context)) {
+            return false;
+        }
+    }
+
+    for (uint32_t i = object + 1; i < end; i = plain_json_skip(context, i)) {
+        const uint32_t key_index = plain_json_intern_get_key_index(context, i);
+        const plain_json_String key = plain_json_intern_get_entry(context, key_index);
+        const uint32_t hash = plain_json_get_key_hash(context, key_index);
+
+        plain_json_MemberSlot *slot =
+            plain_json_intern_find_member(context, object, hash, key.data, key.length);
+        if (slot->member == PLAIN_JSON_NO_KEY) {
+            slot->hash = hash;
+            slot->object = object;
+            slot->member = i;
+            context->member_count++;
         }
-        break;
     }
 
-    return PLAIN_JSON_ERROR_KEYWORD_INVALID;
+    plain_json_MemberSlot *marker = plain_json_intern_find_marker(context, object);
+    marker->hash = 0;
+    marker->object = object;
+    marker->member = object;
+    context->member_count++;
+    return true;
 }
 
-static inline plain_json_ErrorType
-plain_json_intern_read_number(plain_json_Context *context, plain_json_Token *token) {
-    enum {
-        READ_INT,
-        READ_DECIMAL,
-        READ_EXPO,
-    } status = READ_INT;
+static uint32_t plain_json_intern_object_get(
+    plain_json_Context *context, uint32_t object_index, const uint8_t *key, uint32_t length,
+    uint32_t hash
+) {
+    if (plain_json_get_type(context, object_index) != PLAIN_JSON_TYPE_OBJECT_START) {
+        return PLAIN_JSON_NO_KEY;
+    }
 
-    static const int64_t int_max = INT64_MAX;
+    const uint32_t end = plain_json_intern_get_end(context, object_index);
+    if (end == PLAIN_JSON_NO_KEY) {
+        return PLAIN_JSON_NO_KEY;
+    }
 
-    const uint8_t *buffer = context->buffer + context->buffer_offset;
-    uintptr_t buffer_size = context->buffer_size - context->buffer_offset;
-    uintptr_t offset = 0;
+    /* Fall back to a linear search, if the index can not be allocated */
+    const uint32_t member_count =
+        plain_json_intern_get_value(context, object_index)->container.child_count;
+    if (member_count >= PLAIN_JSON_MEMBER_INDEX_MIN &&
+        plain_json_intern_index_object(context, object_index, end, member_count)) {
+        return plain_json_intern_find_member(context, object_index, hash, key, length)->member;
+    }
 
-    uint8_t int_has_sign = 0;
-    int64_t int_value = 0;
+    for (uint32_t i = object_index + 1; i < end; i = plain_json_skip(context, i)) {
+        const uint32_t key_index = plain_json_intern_get_key_index(context, i);
+        if (plain_json_key_equals(context, key_index, key, length)) {
+            return i;
+        }
+    }
 
-    __attribute__((unused)) uint8_t expo_has_sign = 0;
-    intptr_t expo_value = 0;
+    return PLAIN_JSON_NO_KEY;
+}
 
-    __attribute__((unused)) uint32_t decimal_start = 0;
-    __attribute__((unused)) uint32_t decimal_length = 0;
+uint32_t plain_json_object_get(
+    plain_json_Context *context, uint32_t object_index, const uint8_t *key, uint32_t length
+) {
+    const uint32_t hash = plain_json_intern_hash(key, length);
+    return plain_json_intern_object_get(context, object_index, key, length, hash);
+}
 
-    while (offset < buffer_size) {
-        switch (buffer[offset]) {
-        case '0':
-            if (status == READ_INT && (offset == 0 || (offset == 1 && int_has_sign))) {
-                if (offset + 1 < buffer_size && is_digit(buffer[offset + 1])) {
-                    return PLAIN_JSON_ERROR_NUMBER_LEADING_ZERO;
-                }
-            }
-            /* fallthrough */
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-            if (status == READ_INT) {
-                /* Check for over/underflow */
-
-                // FIXME: Depending on the wordsize, the int_max value might end in different digits
-                // (ie. i32 => '8', i64 => '7').
-                if (!int_has_sign) {
-                    if (int_value > (int_max / 10) ||
-                        (int_value == (int_max / 10) && buffer[offset] > '7')) {
-                        return PLAIN_JSON_ERROR_NUMBER_OVERFLOW;
-                    }
+uint32_t plain_json_array_get(plain_json_Context *context, uint32_t array_index, uint32_t element) {
+    if (plain_json_get_type(context, array_index) != PLAIN_JSON_TYPE_ARRAY_START) {
+        return PLAIN_JSON_NO_KEY;
+    }
 
-                    int_value *= 10;
-                    int_value += buffer[offset] - '0';
-                } else {
-                    if (int_value < (int_max / 10) * -1 ||
-                        (int_value == (int_max / 10) * -1 && buffer[offset] > '8')) {
-                        return PLAIN_JSON_ERROR_NUMBER_UNDERFLOW;
-                    }
+    const uint32_t end = plain_json_intern_get_end(context, array_index);
+    const uint32_t element_count =
+        plain_json_intern_get_value(context, array_index)->container.child_count;
+    if (end == PLAIN_JSON_NO_KEY || element >= element_count) {
+        return PLAIN_JSON_NO_KEY;
+    }
 
-                    int_value *= 10;
-                    int_value -= buffer[offset] - '0';
-                }
+    /* Without nested containers, each element is a single token */
+    if (end - array_index - 1 == element_count) {
+        return array_index + 1 + element;
+    }
 
-                if (offset + 1 < buffer_size && buffer[offset + 1] == '.') {
-                    status = READ_DECIMAL;
-                    decimal_start = offset + 1;
-                    offset += 1;
+    uint32_t index = array_index + 1;
+    for (uint32_t i = 0; i < element; i++) {
+        index = plain_json_skip(context, index);
+    }
 
-                    if (offset + 1 < buffer_size && !is_digit(buffer[offset + 1])) {
-                        return PLAIN_JSON_ERROR_NUMBER_INVALID_DECIMAL;
-                    }
-                }
-            }
+    return index;
+}
 
-            if (status == READ_EXPO) {
-                /* TODO: Make sure the resulting number (int/float * expo) can fit into the wordsize
-                 */
-                if (expo_value > (int_max / 10) ||
-                    (int_value == (int_max / 10) && buffer[offset] > '7')) {
-                    return PLAIN_JSON_ERROR_NUMBER_OVERFLOW;
-                }
+plain_json_Pointer *plain_json_pointer_compile(
+    plain_json_AllocatorConfig alloc_config, const uint8_t *pointer, uint32_t length,
+    plain_json_ErrorType *error
+) {
+    /* The empty pointer references the whole document, all others start with a '/' */
+    uint32_t segment_count = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        segment_count += pointer[i] == '/';
+    }
 
-                expo_value *= 10;
-                expo_value += buffer[offset] - '0';
-            }
+    if (length > 0 && pointer[0] != '/') {
+        (*error) = PLAIN_JSON_ERROR_POINTER_INVALID;
+        return PLAIN_JSON_NULL;
+    }
 
-            break;
-        case '-':
-            if (status == READ_INT && offset == 0) {
-                int_has_sign = 1;
-                if (offset + 1 < buffer_size && !is_digit(buffer[offset + 1])) {
-                    return PLAIN_JSON_ERROR_NUMBER_INVALID_SIGN;
+    /* The segments and their unescaped names follow the pointer, in a single allocation */
+    const uintptr_t size = sizeof(plain_json_Pointer) +
+                           segment_count * sizeof(plain_json_PointerSegment) + length;
+    plain_json_Pointer *result = alloc_config.alloc_func(alloc_config.context, size);
+    if (result == PLAIN_JSON_NULL) {
+        (*error) = PLAIN_JSON_ERROR_NO_MEMORY;
+        return PLAIN_JSON_NULL;
+    }
+
+    result->alloc_config = alloc_config;
+    result->segment_count = segment_count;
+    result->segments = (plain_json_PointerSegment *)(result + 1);
+    result->names = (uint8_t *)(result->segments + segment_count);
+
+    uint32_t offset = 1;
+    uint32_t name_offset = 0;
+    for (uint32_t i = 0; i < segment_count; i++) {
+        plain_json_PointerSegment *segment = &result->segments[i];
+        segment->offset = name_offset;
+
+        for (; offset < length && pointer[offset] != '/'; offset++) {
+            uint8_t current_char = pointer[offset];
+            if (current_char == '~') {
+                const uint8_t next_char = offset + 1 < length ? pointer[offset + 1] : 0;
+                if (next_char != '0' && next_char != '1') {
+                    alloc_config.free_func(alloc_config.context, result);
+                    (*error) = PLAIN_JSON_ERROR_POINTER_INVALID;
+                    return PLAIN_JSON_NULL;
                 }
 
-                break;
+                current_char = next_char == '0' ? '~' : '/';
+                offset++;
             }
 
-            /* '+/-' are consumed as part of the exponent token 'e' */
-            /* fallthrough */
-        case '+':
-            return PLAIN_JSON_ERROR_NUMBER_INVALID_SIGN;
-            /* '.' is consumed as part of the int part */
-        case '.':
-            return PLAIN_JSON_ERROR_NUMBER_INVALID_DECIMAL;
-        case 'e':
-        case 'E':
-            if (status == READ_EXPO) {
-                return PLAIN_JSON_ERROR_NUMBER_INVALID_EXPO;
-            }
+            result->names[name_offset++] = current_char;
+        }
+        offset++;
 
-            if (offset + 1 >= buffer_size) {
-                return PLAIN_JSON_ERROR_UNEXPECTED_EOF;
-            }
+        segment->length = name_offset - segment->offset;
 
-            if (status != READ_INT) {
-                decimal_length = offset - decimal_start;
-            }
+        const uint8_t *name = result->names + segment->offset;
+        segment->hash = plain_json_intern_hash(name, segment->length);
 
-            uint8_t next_char = buffer[offset + 1];
-            if (next_char == '+' || next_char == '-') {
-                offset += 1;
-                expo_has_sign = 1;
+        /* Array indices are "0" or digits without a leading zero. Others (like "-", which is
+         * past the last element) never match an element. */
+        segment->index = PLAIN_JSON_NO_KEY;
+        if (segment->length > 0 && (segment->length == 1 || name[0] != '0')) {
+            uint64_t index = 0;
+            uint32_t j = 0;
+            for (; j < segment->length && is_digit(name[j]) && index < PLAIN_JSON_NO_KEY; j++) {
+                index = index * 10 + (name[j] - '0');
             }
 
-            if (offset + 1 < buffer_size && !is_digit(buffer[offset + 1])) {
-                return PLAIN_JSON_ERROR_NUMBER_INVALID_EXPO;
+            if (j == segment->length && index < PLAIN_JSON_NO_KEY) {
+                segment->index = (uint32_t)index;
             }
+        }
+    }
 
-            status = READ_EXPO;
-            break;
+    (*error) = PLAIN_JSON_DONE;
+    return result;
+}
+
+uint32_t plain_json_pointer_get(
+    plain_json_Context *context, const plain_json_Pointer *pointer, uint32_t index
+) {
+    if (index >= context->token_buffer.item_count) {
+        return PLAIN_JSON_NO_KEY;
+    }
 
+    for (uint32_t i = 0; i < pointer->segment_count && index != PLAIN_JSON_NO_KEY; i++) {
+        const plain_json_PointerSegment *segment = &pointer->segments[i];
+
+        switch (plain_json_get_type(context, index)) {
+        case PLAIN_JSON_TYPE_OBJECT_START:
+            index = plain_json_intern_object_get(
+                context, index, pointer->names + segment->offset, segment->length, segment->hash
+            );
+            break;
+        case PLAIN_JSON_TYPE_ARRAY_START:
+            index = segment->index != PLAIN_JSON_NO_KEY
+                        ? plain_json_array_get(context, index, segment->index)
+                        : PLAIN_JSON_NO_KEY;
+            break;
         default:
-            goto done;
+            index = PLAIN_JSON_NO_KEY;
+            break;
         }
+    }
+
+    return index;
+}
+
+void plain_json_pointer_free(plain_json_Pointer *pointer) {
+    if (pointer == PLAIN_JSON_NULL) {
+        return;
+    }
 
+    pointer->alloc_config.free_func(pointer->alloc_config.context, pointer);
+}
+
+/* Parse a (non negative) index of a query slice. Returns false if there are no digits. */
+static bool plain_json_intern_parse_index(
+    const uint8_t *query, uint32_t length, uint32_t *offset_ptr, uint32_t *index
+) {
+    uint32_t offset = *offset_ptr;
+    uint64_t value = 0;
+
+    while (offset < length && is_digit(query[offset]) && value < PLAIN_JSON_NO_KEY) {
+        value = value * 10 + (query[offset] - '0');
         offset++;
     }
 
-done:
-    switch (status) {
-    case READ_INT:
-        token->value.integer = int_value;
-        break;
-    case READ_DECIMAL:
-        token->value.float32 = 0;
-        break;
-    case READ_EXPO:
-        break;
+    if (offset == *offset_ptr || value >= PLAIN_JSON_NO_KEY) {
+        return false;
     }
 
-    token->length = offset;
-    plain_json_intern_consume(context, offset);
-    return PLAIN_JSON_HAS_REMAINING;
+    (*offset_ptr) = offset;
+    (*index) = (uint32_t)value;
+    return true;
 }
 
-    #define get_state()      context->depth_buffer[context->depth_buffer_index]
-    #define set_state(state) (get_state() = (state))
-    #define has_state(state) ((get_state() & (state)) > 0)
+/* Characters of a dot notation name (RFC 9535): letters, '_' and non ASCII, or digits after the
+ * first one. Anything else needs the bracket notation. */
+static inline bool plain_json_intern_is_name_char(uint8_t c, bool first) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c >= 0x80 ||
+           (!first && is_digit(c));
+}
 
-    #define check_for_comma()                              \
-        if (has_state(PLAIN_JSON_STATE_NEEDS_COMMA) > 0) { \
-            status = PLAIN_JSON_ERROR_MISSING_COMMA;       \
-            break;                                         \
-        }
-    #define check_state(state)                      \
-        if (!has_state(state)) {                    \
-            status = PLAIN_JSON_ERROR_ILLEGAL_CHAR; \
-            break;                                  \
+/* Parse a bracketed selector, starting after the '[' */
+static bool plain_json_intern_parse_selector(
+    const uint8_t *query, uint32_t length, uint32_t *offset_ptr, plain_json_QuerySegment *segment,
+    uint8_t *names
+) {
+    uint32_t offset = *offset_ptr;
+    if (offset >= length) {
+        return false;
+    }
+
+    if (query[offset] == '*') {
+        segment->selector = PLAIN_JSON_SELECTOR_WILDCARD;
+        offset++;
+    } else if (query[offset] == '\'' || query[offset] == '\"') {
+        /* Quoted names, where a backslash escapes the next character */
+        const uint8_t quote = query[offset++];
+        segment->selector = PLAIN_JSON_SELECTOR_NAME;
+
+        while (offset < length && query[offset] != quote) {
+            if (query[offset] == '\\' && offset + 1 < length) {
+                offset++;
+            }
+            names[segment->offset + segment->length++] = query[offset++];
         }
 
-    #define push_state()                                                     \
-        if (context->depth_buffer_index + 1 < PLAIN_JSON_OPTION_MAX_DEPTH) { \
-            context->depth_buffer_index++;                                   \
-        } else {                                                             \
-            status = PLAIN_JSON_ERROR_NESTING_TOO_DEEP;                      \
-            break;                                                           \
+        if (offset >= length) {
+            return false;
         }
-    #define pop_state()                                \
-        if (context->depth_buffer_index > 0) {         \
-            context->depth_buffer_index--;             \
-        } else {                                       \
-            status = PLAIN_JSON_ERROR_UNEXPECTED_ROOT; \
-            break;                                     \
+        offset++;
+    } else {
+        /* An index or a slice "[start:end:step]" where all parts are optional */
+        segment->selector = PLAIN_JSON_SELECTOR_SLICE;
+        segment->start = 0;
+        segment->end = PLAIN_JSON_NO_KEY;
+        segment->step = 1;
+
+        const bool has_start =
+            plain_json_intern_parse_index(query, length, &offset, &segment->start);
+        if (offset < length && query[offset] == ':') {
+            offset++;
+            plain_json_intern_parse_index(query, length, &offset, &segment->end);
+
+            if (offset < length && query[offset] == ':') {
+                offset++;
+                if (plain_json_intern_parse_index(query, length, &offset, &segment->step) &&
+                    segment->step == 0) {
+                    return false;
+                }
+            }
+        } else if (has_start) {
+            segment->end = segment->start + 1;
+        } else {
+            return false;
         }
+    }
 
-static plain_json_ErrorType
-plain_json_intern_read_token(plain_json_Context *context, plain_json_Token *token) {
-    /* Indicate if this value is prefixed by a comma. Objects/Array can be
-     * empty, meaning we can't rely on the state to tell us is if a comma
-     * has been processed. */
-    bool has_comma = false;
-    plain_json_ErrorType status = PLAIN_JSON_HAS_REMAINING;
+    if (offset >= length || query[offset] != ']') {
+        return false;
+    }
 
-    while (plain_json_intern_has_next(context, 0)) {
-        token->start = context->buffer_offset;
-        token->length = 1;
+    (*offset_ptr) = offset + 1;
+    return true;
+}
 
-        uint8_t current_char = plain_json_intern_peek(context, 0);
-        switch (current_char) {
-            /* Read blanks */
-        case ' ':
-        case '\t':
-        case '\n':
-        case '\r':
-            plain_json_intern_consume(context, 1);
-            continue;
-        case '{':
-            /* The file root may contain object/arrays */
-            check_state(
-                PLAIN_JSON_STATE_NEEDS_VALUE | PLAIN_JSON_STATE_NEEDS_ARRAY_VALUE |
-                PLAIN_JSON_STATE_IS_FIRST_TOKEN
-            );
-            check_for_comma();
-            plain_json_intern_consume(context, 1);
-            if (has_state(PLAIN_JSON_STATE_NEEDS_VALUE)) {
-                set_state(PLAIN_JSON_STATE_NEEDS_KEY);
-            }
+plain_json_Query *plain_json_query_compile(
+    plain_json_AllocatorConfig alloc_config, const uint8_t *query, uint32_t length,
+    plain_json_ErrorType *error
+) {
+    if (length == 0 || query[0] != '$') {
+        (*error) = PLAIN_JSON_ERROR_QUERY_INVALID;
+        return PLAIN_JSON_NULL;
+    }
 
-            set_state(get_state() | PLAIN_JSON_STATE_NEEDS_COMMA);
-            push_state();
-            set_state(PLAIN_JSON_STATE_NEEDS_KEY);
+    /* Each segment takes up at least two characters, names at most the whole query */
+    const uint32_t max_segments = length / 2;
+    const uintptr_t size =
+        sizeof(plain_json_Query) + max_segments * sizeof(plain_json_QuerySegment) + length;
+    plain_json_Query *result = alloc_config.alloc_func(alloc_config.context, size);
+    if (result == PLAIN_JSON_NULL) {
+        (*error) = PLAIN_JSON_ERROR_NO_MEMORY;
+        return PLAIN_JSON_NULL;
+    }
 
-            token->type = PLAIN_JSON_TYPE_OBJECT_START;
-            break;
-        case '}':
-            check_state(PLAIN_JSON_STATE_NEEDS_KEY);
-            if (has_comma) {
-                status = PLAIN_JSON_ERROR_UNEXPECTED_COMMA;
-                break;
+    result->alloc_config = alloc_config;
+    result->segment_count = 0;
+    result->segments = (plain_json_QuerySegment *)(result + 1);
+    result->names = (uint8_t *)(result->segments + max_segments);
+
+    uint32_t offset = 1;
+    uint32_t name_offset = 0;
+    while (offset < length) {
+        plain_json_QuerySegment segment = { 0 };
+        segment.offset = name_offset;
+
+        bool valid = result->segment_count < 63;
+        if (query[offset] == '.') {
+            offset++;
+            if (offset < length && query[offset] == '.') {
+                segment.descendant = true;
+                offset++;
             }
-            pop_state();
-
-            plain_json_intern_consume(context, 1);
-            token->type = PLAIN_JSON_TYPE_OBJECT_END;
-            break;
-        case '[':
-            check_state(
-                PLAIN_JSON_STATE_NEEDS_VALUE | PLAIN_JSON_STATE_NEEDS_ARRAY_VALUE |
-                PLAIN_JSON_STATE_IS_FIRST_TOKEN
-            );
-            check_for_comma();
 
-            if (has_state(PLAIN_JSON_STATE_NEEDS_VALUE)) {
-                set_state(PLAIN_JSON_STATE_NEEDS_KEY);
+            if (offset < length && query[offset] == '[' && segment.descendant) {
+                offset++;
+                valid = valid && plain_json_intern_parse_selector(
+                                     query, length, &offset, &segment, result->names
+                                 );
+            } else if (offset < length && query[offset] == '*') {
+                segment.selector = PLAIN_JSON_SELECTOR_WILDCARD;
+                offset++;
+            } else {
+                segment.selector = PLAIN_JSON_SELECTOR_NAME;
+                while (offset < length &&
+                       plain_json_intern_is_name_char(query[offset], segment.length == 0)) {
+                    result->names[name_offset + segment.length++] = query[offset++];
+                }
+                valid = valid && segment.length > 0;
             }
-            set_state(get_state() | PLAIN_JSON_STATE_NEEDS_COMMA);
-            push_state();
-            set_state(PLAIN_JSON_STATE_NEEDS_ARRAY_VALUE);
+        } else if (query[offset] == '[') {
+            offset++;
+            valid = valid && plain_json_intern_parse_selector(
+                                 query, length, &offset, &segment, result->names
+                             );
+        } else {
+            valid = false;
+        }
 
-            plain_json_intern_consume(context, 1);
-            token->type = PLAIN_JSON_TYPE_ARRAY_START;
-            break;
-        case ']':
-            check_state(PLAIN_JSON_STATE_NEEDS_ARRAY_VALUE);
-            if (has_comma) {
-                return PLAIN_JSON_ERROR_UNEXPECTED_COMMA;
-            }
-            pop_state();
+        if (!valid) {
+            alloc_config.free_func(alloc_config.context, result);
+            (*error) = PLAIN_JSON_ERROR_QUERY_INVALID;
+            return PLAIN_JSON_NULL;
+        }
 
-            plain_json_intern_consume(context, 1);
-            token->type = PLAIN_JSON_TYPE_ARRAY_END;
-            break;
-        case ',':
-            check_state(PLAIN_JSON_STATE_NEEDS_COMMA);
-            /* The root level can only contain a single value */
-            if (has_state(PLAIN_JSON_STATE_IS_ROOT)) {
-                status = PLAIN_JSON_ERROR_UNEXPECTED_COMMA;
-                break;
-            }
-            set_state(get_state() ^ PLAIN_JSON_STATE_NEEDS_COMMA);
+        segment.hash = plain_json_intern_hash(result->names + segment.offset, segment.length);
+        name_offset += segment.length;
+        result->segments[result->segment_count++] = segment;
+    }
 
-            plain_json_intern_consume(context, 1);
-            has_comma = true;
-            continue;
-        case ':':
-            check_state(PLAIN_JSON_STATE_NEEDS_COLON);
-            set_state(PLAIN_JSON_STATE_NEEDS_VALUE);
-            plain_json_intern_consume(context, 1);
-            continue;
-        case '"':
-            check_for_comma();
-            plain_json_intern_consume(context, 1);
+    (*error) = PLAIN_JSON_DONE;
+    return result;
+}
 
-            if (has_state(PLAIN_JSON_STATE_NEEDS_KEY)) {
-                set_state(PLAIN_JSON_STATE_NEEDS_COLON);
+void plain_json_query_free(plain_json_Query *query) {
+    if (query == PLAIN_JSON_NULL) {
+        return;
+    }
 
-                token->key_index = context->string_buffer.item_count;
-                status = plain_json_intern_read_string(context);
-                if (status != PLAIN_JSON_HAS_REMAINING) {
-                    break;
-                }
-                continue;
+    query->alloc_config.free_func(query->alloc_config.context, query);
+}
 
-            } else if (has_state(
-                           PLAIN_JSON_STATE_NEEDS_VALUE | PLAIN_JSON_STATE_NEEDS_ARRAY_VALUE |
-                           PLAIN_JSON_STATE_IS_FIRST_TOKEN
-                       )) {
-                if (has_state(PLAIN_JSON_STATE_NEEDS_VALUE)) {
-                    set_state(PLAIN_JSON_STATE_NEEDS_KEY);
-                }
-                set_state(get_state() | PLAIN_JSON_STATE_NEEDS_COMMA);
+plain_json_Mask *plain_json_mask_compile(
+    plain_json_AllocatorConfig alloc_config, const uint8_t *mask, uint32_t length,
+    plain_json_ErrorType *error
+) {
+    /* Each key takes up at least two characters (with its separator), besides the root */
+    const uint32_t max_nodes = 1 + (length + 1) / 2;
+    const uintptr_t size =
+        sizeof(plain_json_Mask) + max_nodes * sizeof(plain_json_MaskNode) + length;
+    plain_json_Mask *result = alloc_config.alloc_func(alloc_config.context, size);
+    if (result == PLAIN_JSON_NULL) {
+        (*error) = PLAIN_JSON_ERROR_NO_MEMORY;
+        return PLAIN_JSON_NULL;
+    }
 
-                token->start = context->buffer_offset;
-                token->type = PLAIN_JSON_TYPE_STRING;
-                token->value.string_index = context->string_buffer.item_count;
-                status = plain_json_intern_read_string(context);
-                break;
+    result->alloc_config = alloc_config;
+    result->nodes = (plain_json_MaskNode *)(result + 1);
+    result->names = (uint8_t *)(result->nodes + max_nodes);
+    plain_json_intern_memset(&result->nodes[0], 0, sizeof(result->nodes[0]));
+    result->nodes[0].first_child = PLAIN_JSON_NO_KEY;
+    result->nodes[0].next_sibling = PLAIN_JSON_NO_KEY;
+    result->node_count = 1;
+
+    uint32_t offset = 0;
+    uint32_t name_offset = 0;
+    while (true) {
+        uint32_t parent = 0;
+        while (true) {
+            plain_json_MaskNode node = { 0 };
+            node.offset = name_offset;
+            node.first_child = PLAIN_JSON_NO_KEY;
+
+            while (offset < length && mask[offset] != '.' && mask[offset] != ',') {
+                if (mask[offset] == '\\' && offset + 1 < length) {
+                    offset++;
+                }
+                result->names[name_offset++] = mask[offset++];
             }
 
-            status = PLAIN_JSON_ERROR_ILLEGAL_CHAR;
-            break;
-        case 'n':
-        case 't':
-        case 'f':
-            check_state(
-                PLAIN_JSON_STATE_NEEDS_VALUE | PLAIN_JSON_STATE_NEEDS_ARRAY_VALUE |
-                PLAIN_JSON_STATE_IS_FIRST_TOKEN
-            );
-            check_for_comma();
-            if (has_state(PLAIN_JSON_STATE_NEEDS_VALUE)) {
-                set_state(PLAIN_JSON_STATE_NEEDS_KEY);
+            node.length = name_offset - node.offset;
+            if (node.length == 0) {
+                alloc_config.free_func(alloc_config.context, result);
+                (*error) = PLAIN_JSON_ERROR_MASK_INVALID;
+                return PLAIN_JSON_NULL;
             }
-            set_state(get_state() | PLAIN_JSON_STATE_NEEDS_COMMA);
-            status = plain_json_intern_read_keyword(context, token);
-            break;
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-        case '0':
-        case '-':
-        case '+':
-            check_state(
-                PLAIN_JSON_STATE_NEEDS_VALUE | PLAIN_JSON_STATE_NEEDS_ARRAY_VALUE |
-                PLAIN_JSON_STATE_IS_FIRST_TOKEN
-            );
-            check_for_comma();
-            if (has_state(PLAIN_JSON_STATE_NEEDS_VALUE)) {
-                set_state(PLAIN_JSON_STATE_NEEDS_KEY);
+            node.hash = plain_json_intern_hash(result->names + node.offset, node.length);
+
+            /* Paths starting with the same keys share their nodes */
+            uint32_t child = result->nodes[parent].first_child;
+            while (child != PLAIN_JSON_NO_KEY) {
+                const plain_json_MaskNode *other = &result->nodes[child];
+                if (other->hash == node.hash && other->length == node.length &&
+                    plain_json_intern_memcmp(
+                        result->names + other->offset, result->names + node.offset, node.length
+                    ) == 0) {
+                    break;
+                }
+                child = other->next_sibling;
             }
-            set_state(get_state() | PLAIN_JSON_STATE_NEEDS_COMMA);
-
-            token->type = PLAIN_JSON_TYPE_INTEGER;
-            status = plain_json_intern_read_number(context, token);
-            break;
-        default:
-            status = PLAIN_JSON_ERROR_ILLEGAL_CHAR;
-            break;
-        }
 
-        /* Workaround to correctly handle lone values at root level */
-        context->depth_buffer[0] = PLAIN_JSON_STATE_IS_ROOT;
+            if (child == PLAIN_JSON_NO_KEY) {
+                child = result->node_count++;
+                node.next_sibling = result->nodes[parent].first_child;
+                result->nodes[parent].first_child = child;
+                result->nodes[child] = node;
+            } else {
+                name_offset = node.offset;
+            }
 
-        if (status != PLAIN_JSON_HAS_REMAINING) {
-            token->type = PLAIN_JSON_TYPE_ERROR;
-            token->start = context->buffer_offset;
-            token->value.string_index = 0;
+            parent = child;
+            if (offset == length || mask[offset] == ',') {
+                break;
+            }
+            offset++;
         }
 
-        return status;
-    }
-
-    if (has_state(PLAIN_JSON_STATE_IS_ROOT)) {
-        return PLAIN_JSON_DONE;
+        result->nodes[parent].keep_all = true;
+        if (offset == length) {
+            break;
+        }
+        offset++;
     }
 
-    return PLAIN_JSON_ERROR_UNEXPECTED_EOF;
+    (*error) = PLAIN_JSON_DONE;
+    return result;
 }
 
-plain_json_Context *plain_json_parse(
-    plain_json_AllocatorConfig alloc_config, const uint8_t *buffer, uintptr_t buffer_size,
-    plain_json_ErrorType *error
-) {
-    plain_json_Context *context = alloc_config.alloc_func(alloc_config.context, sizeof(*context));
-    plain_json_intern_memset(context, 0, sizeof(*context));
-
-    context->alloc_config = alloc_config;
-    context->string_buffer.page_size = PLAIN_JSON_STRING_PAGESIZE;
-    context->string_buffer.item_size = 1;
-    context->token_buffer.page_size = PLAIN_JSON_TOKEN_PAGESIZE;
-    context->token_buffer.item_size = sizeof(plain_json_Token);
-
-    context->depth_buffer_index = 0;
-    /* Workaround to correctly handle lone values at root level. This state is only valid for the
-     * topmost/first parsed token */
-    context->depth_buffer[0] = PLAIN_JSON_STATE_IS_FIRST_TOKEN;
+void plain_json_mask_free(plain_json_Mask *mask) {
+    if (mask == PLAIN_JSON_NULL) {
+        return;
+    }
 
-    context->buffer = (uint8_t *)buffer;
-    context->buffer_size = buffer_size;
+    mask->alloc_config.free_func(mask->alloc_config.context, mask);
+}
 
-    plain_json_ErrorType status = PLAIN_JSON_HAS_REMAINING;
-    while (status == PLAIN_JSON_HAS_REMAINING) {
-        plain_json_Token token = { 0 };
+bool plain_json_cursor_root(plain_json_Context *context, plain_json_Cursor *cursor) {
+    if (context->token_buffer.item_count == 0) {
+        return false;
+    }
 
-        token.type = PLAIN_JSON_TYPE_INVALID;
-        token.key_index = PLAIN_JSON_NO_KEY;
-        token.value.float64 = 0;
+    cursor->index = 0;
+    cursor->parent = PLAIN_JSON_NO_KEY;
+    cursor->depth = 0;
+    return true;
+}
 
-        status = plain_json_intern_read_token(context, &token);
+bool plain_json_cursor_first_child(plain_json_Context *context, plain_json_Cursor *cursor) {
+    const plain_json_Type type = plain_json_get_type(context, cursor->index);
+    if (type != PLAIN_JSON_TYPE_OBJECT_START && type != PLAIN_JSON_TYPE_ARRAY_START) {
+        return false;
+    }
 
-        if (status != PLAIN_JSON_DONE &&
-            !plain_json_intern_list_append(
-                &context->token_buffer, &context->alloc_config, &token, 1
-            )) {
-            (*error) = status;
-            return context;
-        }
+    const plain_json_Type child = plain_json_get_type(context, cursor->index + 1);
+    if (child == PLAIN_JSON_TYPE_INVALID || child == PLAIN_JSON_TYPE_OBJECT_END ||
+        child == PLAIN_JSON_TYPE_ARRAY_END) {
+        return false;
     }
 
-    (*error) = status;
-    return context;
+    cursor->parent = cursor->index;
+    cursor->index++;
+    cursor->depth++;
+    return true;
 }
 
-void plain_json_free(plain_json_Context *context) {
-    plain_json_AllocatorConfig config = context->alloc_config;
-    if (context->token_buffer.buffer != PLAIN_JSON_NULL) {
-        config.free_func(config.context, context->token_buffer.buffer);
-        context->token_buffer.buffer = PLAIN_JSON_NULL;
-    }
-    if (context->string_buffer.buffer != PLAIN_JSON_NULL) {
-        config.free_func(config.context, context->string_buffer.buffer);
-        context->string_buffer.buffer = PLAIN_JSON_NULL;
+bool plain_json_cursor_next_sibling(plain_json_Context *context, plain_json_Cursor *cursor) {
+    if (cursor->parent == PLAIN_JSON_NO_KEY) {
+        return false;
     }
 
-    config.free_func(config.context, context);
-}
+    const uint32_t next = plain_json_skip(context, cursor->index);
+    const plain_json_Type type = plain_json_get_type(context, next);
+    if (type == PLAIN_JSON_TYPE_INVALID || type == PLAIN_JSON_TYPE_OBJECT_END ||
+        type == PLAIN_JSON_TYPE_ARRAY_END) {
+        return false;
+    }
 
-const uint8_t *plain_json_get_key(plain_json_Context *context, uint32_t key_index) {
-    return plain_json_list_get(&context->string_buffer, key_index);
+    cursor->index = next;
+    return true;
 }
 
-const uint8_t *plain_json_get_string(plain_json_Context *context, uint32_t key_index) {
-    return plain_json_list_get(&context->string_buffer, key_index);
-}
+bool plain_json_cursor_parent(plain_json_Context *context, plain_json_Cursor *cursor) {
+    if (cursor->parent == PLAIN_JSON_NO_KEY) {
+        return false;
+    }
 
-const plain_json_Token *plain_json_get_token(plain_json_Context *context, uint32_t index) {
-    return (plain_json_Token *)plain_json_list_get(&context->token_buffer, index);
-}
+    /* The parent of the enclosing container is stored on its end token */
+    const uint32_t end = plain_json_intern_get_end(context, cursor->parent);
+    if (end == PLAIN_JSON_NO_KEY) {
+        return false;
+    }
 
-uint32_t plain_json_get_token_count(plain_json_Context *context) {
-    return context->token_buffer.item_count;
+    cursor->index = cursor->parent;
+    cursor->parent = plain_json_intern_get_value(context, end)->container_end.parent_index;
+    cursor->depth--;
+    return true;
 }
 
 bool plain_json_compute_position(
@@ -1176,8 +5616,16 @@ const char *plain_json_error_to_string(plain_json_ErrorType type) {
         return "missing_field_seperator";
     case PLAIN_JSON_ERROR_STRING_INVALID_ESCAPE:
         return "string_invalid_escape";
+    case PLAIN_JSON_ERROR_POINTER_INVALID:
+        return "pointer_invalid";
+    case PLAIN_JSON_ERROR_QUERY_INVALID:
+        return "query_invalid";
+    case PLAIN_JSON_ERROR_MASK_INVALID:
+        return "mask_invalid";
     case PLAIN_JSON_HAS_REMAINING:
         return "parsing_has_remaining";
+    case PLAIN_JSON_BUFFER_FULL:
+        return "buffer_full";
     case PLAIN_JSON_ERROR_NO_MEMORY:
         return "no_memory";
     case PLAIN_JSON_DONE:
@@ -1189,11 +5637,8 @@ const char *plain_json_error_to_string(plain_json_ErrorType type) {
     return "unknown_error";
 }
 
-    #undef check_for_comma
-    #undef verify_state
-    #undef has_state
-    #undef push_state
-    #undef pop_state
+    #undef get_state
+    #undef set_state
 
     #undef is_hex
     #undef is_blank
@@ -1201,16 +5646,73 @@ const char *plain_json_error_to_string(plain_json_ErrorType type) {
     #undef json_assert
 
     #undef PLAIN_JSON_TOKEN_PAGESIZE
+    #undef PLAIN_JSON_ARENA_CHUNKSIZE
+    #undef PLAIN_JSON_ARENA_ALIGNMENT
     #undef PLAIN_JSON_STRING_PAGESIZE
     #undef PLAIN_JSON_STRING_CACHESIZE
-
-    #undef PLAIN_JSON_STATE_IS_FIRST_TOKEN
-    #undef PLAIN_JSON_STATE_IS_ROOT
-
-    #undef PLAIN_JSON_STATE_NEEDS_KEY
-    #undef PLAIN_JSON_STATE_NEEDS_COMMA
-    #undef PLAIN_JSON_STATE_NEEDS_VALUE
-    #undef PLAIN_JSON_STATE_NEEDS_ARRAY_VALUE
-    #undef PLAIN_JSON_STATE_NEEDS_COLON
+    #undef PLAIN_JSON_STRING_REFERENCE
+    #undef PLAIN_JSON_KEY_TABLE_SIZE
+    #undef PLAIN_JSON_DEPTH_INLINE
+    #undef PLAIN_JSON_SELECTOR_NAME
+    #undef PLAIN_JSON_SELECTOR_WILDCARD
+    #undef PLAIN_JSON_SELECTOR_SLICE
+    #undef PLAIN_JSON_MEMBER_TABLE_SIZE
+    #undef PLAIN_JSON_MEMBER_INDEX_MIN
+    #undef PLAIN_JSON_BLOCKSIZE
+
+    #undef PLAIN_JSON_DECIMAL_DIGITS
+    #undef PLAIN_JSON_DECIMAL_MAX_SHIFT
+
+    #undef PLAIN_JSON_UTF8_TOO_SHORT
+    #undef PLAIN_JSON_UTF8_TOO_LONG
+    #undef PLAIN_JSON_UTF8_OVERLONG_3
+    #undef PLAIN_JSON_UTF8_TOO_LARGE
+    #undef PLAIN_JSON_UTF8_SURROGATE
+    #undef PLAIN_JSON_UTF8_OVERLONG_2
+    #undef PLAIN_JSON_UTF8_TOO_LARGE_1000
+    #undef PLAIN_JSON_UTF8_OVERLONG_4
+    #undef PLAIN_JSON_UTF8_TWO_CONTS
+    #undef PLAIN_JSON_UTF8_CARRY
+
+    #undef PLAIN_JSON_STATE_ROOT_START
+    #undef PLAIN_JSON_STATE_ROOT_END
+    #undef PLAIN_JSON_STATE_OBJECT_START
+    #undef PLAIN_JSON_STATE_OBJECT_KEY
+    #undef PLAIN_JSON_STATE_OBJECT_COLON
+    #undef PLAIN_JSON_STATE_OBJECT_VALUE
+    #undef PLAIN_JSON_STATE_OBJECT_COMMA
+    #undef PLAIN_JSON_STATE_ARRAY_START
+    #undef PLAIN_JSON_STATE_ARRAY_VALUE
+    #undef PLAIN_JSON_STATE_ARRAY_COMMA
+    #undef PLAIN_JSON_STATE_COUNT
+
+    #undef PLAIN_JSON_CLASS_OTHER
+    #undef PLAIN_JSON_CLASS_OBJECT_START
+    #undef PLAIN_JSON_CLASS_OBJECT_END
+    #undef PLAIN_JSON_CLASS_ARRAY_START
+    #undef PLAIN_JSON_CLASS_ARRAY_END
+    #undef PLAIN_JSON_CLASS_COMMA
+    #undef PLAIN_JSON_CLASS_COLON
+    #undef PLAIN_JSON_CLASS_QUOTE
+    #undef PLAIN_JSON_CLASS_KEYWORD
+    #undef PLAIN_JSON_CLASS_NUMBER
+    #undef PLAIN_JSON_CLASS_COUNT
+
+    #undef PLAIN_JSON_ACTION_ILLEGAL_CHAR
+    #undef PLAIN_JSON_ACTION_MISSING_COMMA
+    #undef PLAIN_JSON_ACTION_UNEXPECTED_COMMA
+    #undef PLAIN_JSON_ACTION_OBJECT_START
+    #undef PLAIN_JSON_ACTION_OBJECT_END
+    #undef PLAIN_JSON_ACTION_ARRAY_START
+    #undef PLAIN_JSON_ACTION_ARRAY_END
+    #undef PLAIN_JSON_ACTION_COMMA
+    #undef PLAIN_JSON_ACTION_COLON
+    #undef PLAIN_JSON_ACTION_KEY
+    #undef PLAIN_JSON_ACTION_STRING
+    #undef PLAIN_JSON_ACTION_KEYWORD
+    #undef PLAIN_JSON_ACTION_NUMBER
+
+    #undef PLAIN_JSON_COMPUTED_GOTO
+    #undef transition
 
 #endif
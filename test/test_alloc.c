@@ -0,0 +1,284 @@
+#include <string.h>
+
+#include "test_setup.h"
+
+SUIT(alloc, NULL, test_finalize);
+
+static uint32_t alloc_count = 0;
+static uint32_t realloc_count = 0;
+
+static void *counting_alloc(void *ctx, uintptr_t size) {
+    alloc_count += 1;
+    return custom_alloc(ctx, size);
+}
+
+static void *counting_realloc(void *ctx, void *buffer, uintptr_t old_size, uintptr_t new_size) {
+    realloc_count += 1;
+    return custom_realloc(ctx, buffer, old_size, new_size);
+}
+
+static plain_json_AllocatorConfig counting_config(void) {
+    plain_json_AllocatorConfig config = alloc_config;
+    config.alloc_func = counting_alloc;
+    config.realloc_func = counting_realloc;
+    return config;
+}
+
+/* 4096 elements, so 4098 tokens including the array start and end */
+static char *make_array(void) {
+    char *text = malloc(4096 * 2 + 2);
+    text[0] = '[';
+    for (uint32_t i = 0; i < 4096; ++i) {
+        text[1 + i * 2] = '1';
+        text[2 + i * 2] = ',';
+    }
+    text[4096 * 2] = ']';
+    text[4096 * 2 + 1] = '\0';
+    return text;
+}
+
+TEST(alloc, geometric_growth) {
+    char *text = make_array();
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+
+    realloc_count = 0;
+    context = plain_json_parse(counting_config(), (uint8_t *)text, strlen(text), &status);
+    free(text);
+
+    test_assert_eq(status, PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(context), 4098);
+    test_assert_eq(realloc_count < 16, 1);
+}
+
+TEST(alloc, capacity_hints) {
+    char *text = make_array();
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    plain_json_Options options = { 0 };
+    options.token_count_hint = 4098;
+    options.string_size_hint = 64;
+
+    realloc_count = 0;
+    context = plain_json_parse_with_options(
+        counting_config(), options, (uint8_t *)text, strlen(text), &status
+    );
+    free(text);
+
+    test_assert_eq(status, PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(context), 4098);
+    test_assert_eq(realloc_count, 2);
+}
+
+TEST(alloc, exact_size) {
+    /* Escaped quotes and structural characters inside strings must not be counted */
+    const char *text = "{\"a\\\\\": [1, true, \"x\\\"]}\\\\\", {}], \"b\": -2.5e3, \"c\": \"\\u00e9\"}";
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    plain_json_Options options = { 0 };
+    options.flags = PLAIN_JSON_FLAG_EXACT_SIZE;
+
+    realloc_count = 0;
+    context = plain_json_parse_with_options(
+        counting_config(), options, (uint8_t *)text, strlen(text), &status
+    );
+
+    test_assert_eq(status, PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(context), 11);
+    test_assert_eq(realloc_count, 2);
+}
+
+TEST(alloc, reuse_context) {
+    const char *first = "{\"key\": [\"value\", 1, 2, 3]}";
+    const char *second = "[\"other\", 4]";
+    const plain_json_Options options = { 0 };
+
+    context = plain_json_create(counting_config());
+    test_assert_eq(
+        plain_json_parse_into(context, options, (uint8_t *)first, strlen(first)), PLAIN_JSON_DONE
+    );
+
+    /* The buffers are large enough for the second document */
+    realloc_count = 0;
+    test_assert_eq(
+        plain_json_parse_into(context, options, (uint8_t *)second, strlen(second)),
+        PLAIN_JSON_DONE
+    );
+    test_assert_eq(realloc_count, 0);
+    test_assert_eq(plain_json_get_token_count(context), 4);
+
+    const plain_json_Token *token = plain_json_get_token(context, 1);
+    test_assert_eq(token->type, PLAIN_JSON_TYPE_STRING);
+    test_assert_string_eq(
+        (const char *)plain_json_get_string(context, token->value.string_index), "other"
+    );
+
+    plain_json_reset(context);
+    test_assert_eq(plain_json_get_token_count(context), 0);
+}
+
+TEST(alloc, arena_fixed_buffer) {
+    static uint64_t memory[1024];
+    const char *text = "{\"items\": [\"a\", \"b\", {\"c\": 1.5}], \"count\": 3}";
+    plain_json_Arena arena;
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+
+    plain_json_arena_init(&arena, memory, sizeof(memory), NULL);
+    plain_json_Context *arena_context = plain_json_parse(
+        plain_json_arena_allocator(&arena), (uint8_t *)text, strlen(text), &status
+    );
+    test_assert_eq(status, PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(arena_context), 10);
+
+    /* The buffer is too small for this document */
+    char *array = make_array();
+    plain_json_arena_reset(&arena);
+    arena_context = plain_json_parse(
+        plain_json_arena_allocator(&arena), (uint8_t *)array, strlen(array), &status
+    );
+    free(array);
+    test_assert_eq(status, PLAIN_JSON_ERROR_NO_MEMORY);
+}
+
+TEST(alloc, arena_chunks) {
+    char *text = make_array();
+    const plain_json_AllocatorConfig backing = counting_config();
+    const plain_json_Options options = { 0 };
+    plain_json_Arena arena;
+
+    plain_json_arena_init(&arena, NULL, 0, &backing);
+
+    /* Once the arena is large enough, it no longer allocates */
+    for (uint32_t i = 0; i < 4; ++i) {
+        alloc_count = 0;
+        plain_json_arena_reset(&arena);
+        plain_json_Context *arena_context = plain_json_create(plain_json_arena_allocator(&arena));
+        test_assert_eq(
+            plain_json_parse_into(arena_context, options, (uint8_t *)text, strlen(text)),
+            PLAIN_JSON_DONE
+        );
+    }
+    test_assert_eq(alloc_count, 0);
+
+    free(text);
+    plain_json_arena_release(&arena);
+}
+
+TEST(alloc, arena_reuse_buffer) {
+    static uint64_t memory[1024];
+    char *text = make_array();
+    const plain_json_AllocatorConfig backing = counting_config();
+    const plain_json_Options options = { 0 };
+    plain_json_Arena arena;
+
+    /* The document needs more than the buffer, so the first parse spills into a chunk */
+    plain_json_arena_init(&arena, memory, sizeof(memory), &backing);
+    alloc_count = 0;
+    plain_json_Context *arena_context = plain_json_create(plain_json_arena_allocator(&arena));
+    test_assert_eq(
+        plain_json_parse_into(arena_context, options, (uint8_t *)text, strlen(text)),
+        PLAIN_JSON_DONE
+    );
+    test_assert_ne(alloc_count, 0);
+
+    /* The buffer is used again after a reset, with the kept chunk behind it */
+    plain_json_arena_reset(&arena);
+    alloc_count = 0;
+    realloc_count = 0;
+    arena_context = plain_json_create(plain_json_arena_allocator(&arena));
+    test_assert_eq((uint8_t *)arena_context, (uint8_t *)memory);
+    test_assert_eq(
+        plain_json_parse_into(arena_context, options, (uint8_t *)text, strlen(text)),
+        PLAIN_JSON_DONE
+    );
+    test_assert_eq(alloc_count, 0);
+    test_assert_eq(realloc_count, 0);
+
+    /* Resetting the context keeps its buffers, so parsing again allocates nothing at all */
+    plain_json_reset(arena_context);
+    const uintptr_t offset = arena.offset;
+    test_assert_eq(
+        plain_json_parse_into(arena_context, options, (uint8_t *)text, strlen(text)),
+        PLAIN_JSON_DONE
+    );
+    test_assert_eq(alloc_count, 0);
+    test_assert_eq(arena.offset, offset);
+
+    free(text);
+    plain_json_arena_release(&arena);
+}
+
+TEST(alloc, compact_tokens) {
+    const char *text = "{\"a\": [1, 2.5, \"x\"], \"b\": nul}";
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    plain_json_Options options = { 0 };
+    options.flags = PLAIN_JSON_FLAG_COMPACT_TOKENS;
+
+    test_assert_eq(sizeof(plain_json_CompactToken), 16);
+
+    context = plain_json_parse_with_options(
+        alloc_config, options, (uint8_t *)text, strlen(text), &status
+    );
+    test_assert_eq(status, PLAIN_JSON_ERROR_KEYWORD_INVALID);
+    test_assert_eq(plain_json_get_token_count(context), 7);
+    test_assert_eq(plain_json_get_type(context, 2), PLAIN_JSON_TYPE_INTEGER);
+    test_assert_eq(plain_json_get_type(context, 7), PLAIN_JSON_TYPE_INVALID);
+
+    const plain_json_Token *token = plain_json_get_token(context, 1);
+    test_assert_eq(token->type, PLAIN_JSON_TYPE_ARRAY_START);
+    test_assert_string_eq((const char *)plain_json_get_key(context, token->key_index), "a");
+    token = plain_json_get_token(context, 2);
+    test_assert_eq(token->value.integer, 1);
+    test_assert_eq(token->key_index, PLAIN_JSON_NO_KEY);
+
+    /* The error token keeps its position */
+    token = plain_json_get_token(context, 6);
+    test_assert_eq(token->type, PLAIN_JSON_TYPE_ERROR);
+    test_assert_eq(token->start, 26);
+}
+
+TEST(alloc, fixed_buffers) {
+    static uint64_t memory[1024];
+    static plain_json_Token tokens[4];
+    static uint8_t strings[64];
+    const char *text = "{\"a\": [1, 2, 3], \"b\": \"some string\", \"c\": {\"d\": null}, \"e\": 4}";
+    const plain_json_Options options = { 0 };
+
+    test_assert_eq(plain_json_context_size() < sizeof(memory), 1);
+    plain_json_Context *fixed = plain_json_create_fixed(
+        memory, sizeof(memory), tokens, sizeof(tokens), strings, sizeof(strings)
+    );
+    test_assert_ne(fixed, NULL);
+
+    /* Drain the tokens whenever the buffers are full */
+    plain_json_Type types[16];
+    uint32_t type_count = 0;
+    uint32_t pauses = 0;
+
+    plain_json_ErrorType status =
+        plain_json_parse_into(fixed, options, (uint8_t *)text, strlen(text));
+    while (true) {
+        for (uint32_t i = 0; i < plain_json_get_token_count(fixed) && type_count < 16; i++) {
+            types[type_count++] = plain_json_get_token(fixed, i)->type;
+        }
+
+        if (status != PLAIN_JSON_BUFFER_FULL) {
+            break;
+        }
+
+        pauses++;
+        status = plain_json_resume(fixed);
+    }
+
+    test_assert_eq(status, PLAIN_JSON_DONE);
+    test_assert_eq(pauses, 2);
+    test_assert_eq(type_count, 12);
+    test_assert_eq(types[5], PLAIN_JSON_TYPE_ARRAY_END);
+    test_assert_eq(types[6], PLAIN_JSON_TYPE_STRING);
+    test_assert_eq(types[11], PLAIN_JSON_TYPE_OBJECT_END);
+
+    /* A string larger than the whole string buffer can never fit */
+    const char *large = "[\"a string that is longer than the sixty four bytes of the buffer\"]";
+    test_assert_eq(
+        plain_json_parse_into(fixed, options, (uint8_t *)large, strlen(large)),
+        PLAIN_JSON_BUFFER_FULL
+    );
+    test_assert_eq(plain_json_resume(fixed), PLAIN_JSON_ERROR_NO_MEMORY);
+}
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 
 #include "test_setup.h"
 
@@ -21,3 +22,56 @@ TEST_NUMBER(overflow_large, PLAIN_JSON_ERROR_NUMBER_OVERFLOW, 123123123123123123
 TEST_NUMBER(max_negative, PLAIN_JSON_DONE, -9223372036854775808)
 TEST_NUMBER(underflow, PLAIN_JSON_ERROR_NUMBER_UNDERFLOW, -9223372036854775809)
 TEST_NUMBER(underflow_large, PLAIN_JSON_ERROR_NUMBER_UNDERFLOW, -123123123123123123123)
+
+#define TEST_INTEGER(name, encoded)                                                       \
+    TEST(number, name) {                                                                  \
+        const char *text = "[" #encoded "]";                                              \
+        plain_json_ErrorType status = PLAIN_JSON_DONE;                                    \
+        context = plain_json_parse(alloc_config, (uint8_t *)text, strlen(text), &status); \
+        test_assert_eq(status, PLAIN_JSON_DONE);                                          \
+        const plain_json_Token *token = plain_json_get_token(context, 1);                 \
+        test_assert_eq(token->type, PLAIN_JSON_TYPE_INTEGER);                             \
+        test_assert_eq((int64_t)token->value.integer, (int64_t)encoded##LL);              \
+    }
+
+/* Digits are converted in blocks of eight */
+TEST_INTEGER(integer_short, 1234567)
+TEST_INTEGER(integer_block, 12345678)
+TEST_INTEGER(integer_block_remainder, 1700000000123)
+TEST_INTEGER(integer_negative_blocks, -1234567890123456789)
+
+TEST_NUMBER(sign_only, PLAIN_JSON_ERROR_NUMBER_INVALID_SIGN, -)
+TEST_NUMBER(decimal_missing_digits, PLAIN_JSON_ERROR_NUMBER_INVALID_DECIMAL, 1.)
+TEST_NUMBER(expo_missing_digits, PLAIN_JSON_ERROR_NUMBER_INVALID_EXPO, 1e+)
+TEST_NUMBER(float_overflow, PLAIN_JSON_ERROR_NUMBER_OVERFLOW, 1e309)
+TEST_NUMBER(float_underflow, PLAIN_JSON_ERROR_NUMBER_UNDERFLOW, -1.8e308)
+
+/* The compiler converts the same literal, which has to be correctly rounded as well. The bit
+ * patterns are compared to tell apart -0.0 and 0.0 */
+#define TEST_FLOAT(name, encoded)                                                         \
+    TEST(number, name) {                                                                  \
+        const char *text = #encoded;                                                      \
+        plain_json_ErrorType status = PLAIN_JSON_DONE;                                    \
+        context = plain_json_parse(alloc_config, (uint8_t *)text, strlen(text), &status); \
+        test_assert_eq(status, PLAIN_JSON_DONE);                                          \
+        const plain_json_Token *token = plain_json_get_token(context, 0);                 \
+        test_assert_eq(token->type, PLAIN_JSON_TYPE_FLOAT64);                             \
+        const double expected = encoded;                                                  \
+        uint64_t expected_bits = 0, value_bits = 0;                                       \
+        memcpy(&expected_bits, &expected, sizeof(expected));                              \
+        memcpy(&value_bits, &token->value.float64, sizeof(value_bits));                   \
+        test_assert_eq(value_bits, expected_bits);                                        \
+    }
+
+TEST_FLOAT(float_simple, 0.1)
+TEST_FLOAT(float_negative_zero, -0.0)
+TEST_FLOAT(float_exponent, 1e23)
+TEST_FLOAT(float_negative_exponent, -12.5E-3)
+TEST_FLOAT(float_max, 1.7976931348623157e308)
+TEST_FLOAT(float_min_normal, 2.2250738585072014e-308)
+TEST_FLOAT(float_subnormal, 4.9406564584124654e-324)
+/* Exactly halfway between two doubles, rounds to even */
+TEST_FLOAT(float_halfway, 9007199254740993.0)
+/* More digits than fit into the significand */
+TEST_FLOAT(float_long, 0.1000000000000000055511151231257827021181583404541015625)
+TEST_FLOAT(float_long_halfway, 2.2250738585072011360574097967091319759348195463516456480234261e-308)
@@ -0,0 +1,286 @@
+#include <string.h>
+
+#include "test_setup.h"
+
+SUIT(query, NULL, test_finalize);
+
+static uint32_t pointer_get(const char *text) {
+    plain_json_ErrorType status = PLAIN_JSON_NONE;
+    plain_json_Pointer *pointer =
+        plain_json_pointer_compile(alloc_config, (const uint8_t *)text, strlen(text), &status);
+    if (pointer == NULL) {
+        return PLAIN_JSON_NO_KEY - 1;
+    }
+
+    const uint32_t index = plain_json_pointer_get(context, pointer, 0);
+    plain_json_pointer_free(pointer);
+    return index;
+}
+
+TEST(query, pointer) {
+    /* The example document of RFC 6901 */
+    const char *text = "{\"foo\": [\"bar\", \"baz\"], \"\": 0, \"a/b\": 1, \"c%d\": 2, \"e^f\": 3,"
+                       " \"g|h\": 4, \"i\\\\j\": 5, \"k\\\"l\": 6, \" \": 7, \"m~n\": 8}";
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    context = plain_json_parse(alloc_config, (uint8_t *)text, strlen(text), &status);
+    test_assert_eq(status, PLAIN_JSON_DONE);
+
+    test_assert_eq(pointer_get(""), 0);
+    test_assert_eq(pointer_get("/foo"), 1);
+    test_assert_eq(pointer_get("/foo/0"), 2);
+    test_assert_eq(pointer_get("/foo/1"), 3);
+    test_assert_eq(pointer_get("/"), 5);
+    test_assert_eq(pointer_get("/a~1b"), 6);
+    test_assert_eq(pointer_get("/c%d"), 7);
+    test_assert_eq(pointer_get("/e^f"), 8);
+    test_assert_eq(pointer_get("/g|h"), 9);
+    test_assert_eq(pointer_get("/i\\j"), 10);
+    test_assert_eq(pointer_get("/k\"l"), 11);
+    test_assert_eq(pointer_get("/ "), 12);
+    test_assert_eq(pointer_get("/m~0n"), 13);
+
+    test_assert_eq(pointer_get("/foo/2"), PLAIN_JSON_NO_KEY);
+    test_assert_eq(pointer_get("/foo/-"), PLAIN_JSON_NO_KEY);
+    test_assert_eq(pointer_get("/foo/01"), PLAIN_JSON_NO_KEY);
+    test_assert_eq(pointer_get("/foo/0/bar"), PLAIN_JSON_NO_KEY);
+    test_assert_eq(pointer_get("/bar"), PLAIN_JSON_NO_KEY);
+
+    /* Malformed pointers */
+    test_assert_eq(pointer_get("foo"), PLAIN_JSON_NO_KEY - 1);
+    test_assert_eq(pointer_get("/m~2n"), PLAIN_JSON_NO_KEY - 1);
+    test_assert_eq(pointer_get("/m~"), PLAIN_JSON_NO_KEY - 1);
+}
+
+TEST(query, pointer_nested) {
+    const char *text = "{\"payload\": {\"skip\": [[1, 2], {\"x\": {}}], \"items\": ["
+                       "{\"price\": 1}, [2, [3]], {\"price\": 3.5, \"id\": \"c\"}]}}";
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    context = plain_json_parse(alloc_config, (uint8_t *)text, strlen(text), &status);
+    test_assert_eq(status, PLAIN_JSON_DONE);
+
+    const uint32_t index = pointer_get("/payload/items/2/price");
+    test_assert_ne(index, PLAIN_JSON_NO_KEY);
+    test_assert_eq(plain_json_get_token(context, index)->type, PLAIN_JSON_TYPE_FLOAT64);
+    test_assert_eq(plain_json_get_token(context, index)->value.float64, 3.5);
+
+    test_assert_eq(
+        plain_json_get_token(context, pointer_get("/payload/items/1/1/0"))->value.integer, 3
+    );
+    test_assert_eq(pointer_get("/payload/items/3"), PLAIN_JSON_NO_KEY);
+
+    /* Relative to "/payload/items" */
+    plain_json_Pointer *pointer =
+        plain_json_pointer_compile(alloc_config, (const uint8_t *)"/0/price", 8, &status);
+    test_assert_eq(status, PLAIN_JSON_DONE);
+    const uint32_t items = pointer_get("/payload/items");
+    test_assert_eq(
+        plain_json_get_token(context, plain_json_pointer_get(context, pointer, items))
+            ->value.integer,
+        1
+    );
+    plain_json_pointer_free(pointer);
+}
+
+/* Parse 'text', only keeping the values selected by 'query' */
+static plain_json_ErrorType query_parse(const char *query, const char *text) {
+    plain_json_ErrorType status = PLAIN_JSON_NONE;
+    plain_json_Query *compiled =
+        plain_json_query_compile(alloc_config, (const uint8_t *)query, strlen(query), &status);
+    if (compiled == NULL) {
+        return status;
+    }
+
+    plain_json_Options options = { 0 };
+    options.query = compiled;
+    options.flags = PLAIN_JSON_FLAG_INTERN_KEYS;
+    if (context == NULL) {
+        context = plain_json_create(alloc_config);
+    }
+
+    status = plain_json_parse_into(context, options, (uint8_t *)text, strlen(text));
+    plain_json_query_free(compiled);
+    return status;
+}
+
+TEST(query, select) {
+    const char *text = "{\"events\": [{\"user\": {\"id\": 1, \"name\": \"a\"}, \"tags\": [\"x\"]},"
+                       " {\"user\": {\"id\": \"b\"}}, {\"user\": null}, {\"user\": {\"id\": [2]}}],"
+                       " \"id\": 5}";
+
+    test_assert_eq(query_parse("$.events[*].user.id", text), PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(context), 5);
+    test_assert_eq(plain_json_get_token(context, 0)->value.integer, 1);
+    test_assert_eq(plain_json_get_type(context, 1), PLAIN_JSON_TYPE_STRING);
+    const uint32_t string_index = plain_json_get_token(context, 1)->value.string_index;
+    test_assert_string_eq((const char *)plain_json_get_string(context, string_index), "b");
+    test_assert_eq(plain_json_get_type(context, 2), PLAIN_JSON_TYPE_ARRAY_START);
+    test_assert_eq(plain_json_skip(context, 2), 5);
+
+    /* Selected values keep their own key */
+    test_assert_string_eq(
+        (const char *)plain_json_get_key(context, plain_json_get_token(context, 0)->key_index), "id"
+    );
+
+    test_assert_eq(query_parse("$..id", text), PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(context), 6);
+    test_assert_eq(plain_json_get_token(context, 5)->value.integer, 5);
+
+    test_assert_eq(query_parse("$.events[1:4:2]", text), PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(context), 12);
+    test_assert_eq(plain_json_skip(context, 0), 5);
+    test_assert_eq(plain_json_get_type(context, 5), PLAIN_JSON_TYPE_OBJECT_START);
+
+    test_assert_eq(query_parse("$.events[0]['tags'][0]", text), PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(context), 1);
+    test_assert_eq(plain_json_get_type(context, 0), PLAIN_JSON_TYPE_STRING);
+
+    test_assert_eq(query_parse("$.missing", text), PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(context), 0);
+
+    test_assert_eq(query_parse("$._id2", "{\"_id2\": 7, \"id\": 8}"), PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(context), 1);
+    test_assert_eq(plain_json_get_token(context, 0)->value.integer, 7);
+
+    /* The whole document is still validated */
+    test_assert_eq(
+        query_parse("$.id", "{\"a\": [1, 2,], \"id\": 1}"), PLAIN_JSON_ERROR_UNEXPECTED_COMMA
+    );
+}
+
+TEST(query, invalid_query) {
+    const char *queries[] = { "", "a", "$.", "$..", "$[", "$[1", "$['a", "$[a]", "$[-1]", "$[::0]",
+                              "$.a[?(@.b)]", "$.a]", "$.a b", "$.0a", "$.a-b" };
+    for (uint32_t i = 0; i < sizeof(queries) / sizeof(queries[0]); ++i) {
+        test_assert_eq(query_parse(queries[i], "{}"), PLAIN_JSON_ERROR_QUERY_INVALID);
+    }
+}
+
+TEST(query, fixed_context) {
+    static uint64_t memory[1024];
+    static plain_json_Token tokens[16];
+    static uint8_t strings[256];
+    const char *text = "{\"id\": 1, \"x\": 2}";
+    plain_json_ErrorType status = PLAIN_JSON_NONE;
+
+    plain_json_Context *fixed = plain_json_create_fixed(
+        memory, sizeof(memory), tokens, sizeof(tokens), strings, sizeof(strings)
+    );
+    plain_json_Query *query =
+        plain_json_query_compile(alloc_config, (const uint8_t *)"$.id", 4, &status);
+    test_assert_ne(query, NULL);
+
+    /* Fixed contexts can not filter, the unfiltered tokens must not pass for the result */
+    plain_json_Options options = { 0 };
+    options.query = query;
+    test_assert_eq(
+        plain_json_parse_into(fixed, options, (const uint8_t *)text, strlen(text)),
+        PLAIN_JSON_ERROR_QUERY_INVALID
+    );
+    test_assert_eq(plain_json_get_token_count(fixed), 0);
+    plain_json_query_free(query);
+
+    plain_json_Mask *mask =
+        plain_json_mask_compile(alloc_config, (const uint8_t *)"id", 2, &status);
+    test_assert_ne(mask, NULL);
+    options.query = NULL;
+    options.mask = mask;
+    test_assert_eq(
+        plain_json_parse_into(fixed, options, (const uint8_t *)text, strlen(text)),
+        PLAIN_JSON_ERROR_MASK_INVALID
+    );
+    test_assert_eq(plain_json_get_token_count(fixed), 0);
+    plain_json_mask_free(mask);
+
+    options.mask = NULL;
+    test_assert_eq(
+        plain_json_parse_into(fixed, options, (const uint8_t *)text, strlen(text)), PLAIN_JSON_DONE
+    );
+    test_assert_eq(plain_json_get_token_count(fixed), 4);
+}
+
+/* Parse 'text', only keeping the members selected by the field mask 'mask' */
+static plain_json_ErrorType mask_parse(const char *mask, const char *text) {
+    plain_json_ErrorType status = PLAIN_JSON_NONE;
+    plain_json_Mask *compiled =
+        plain_json_mask_compile(alloc_config, (const uint8_t *)mask, strlen(mask), &status);
+    if (compiled == NULL) {
+        return status;
+    }
+
+    plain_json_Options options = { 0 };
+    options.mask = compiled;
+    if (context == NULL) {
+        context = plain_json_create(alloc_config);
+    }
+
+    status = plain_json_parse_into(context, options, (uint8_t *)text, strlen(text));
+    plain_json_mask_free(compiled);
+    return status;
+}
+
+TEST(query, mask) {
+    const char *text = "{\"id\": 7, \"blob\": {\"s\": \"}]\\\"[{\", \"n\": [[{}], -1e5]},"
+                       " \"user\": {\"name\": \"a\", \"age\": 3, \"tags\": [1, {\"x\": 2}]},"
+                       " \"events\": [{\"type\": \"t\", \"data\": [1, 2]}, 3, {\"data\": null}],"
+                       " \"raw\": \"\\u00e9\\\\\"}";
+
+    test_assert_eq(mask_parse("id,user.name,events.type", text), PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(context), 14);
+    test_assert_eq(plain_json_get_token(context, 1)->value.integer, 7);
+    test_assert_eq(plain_json_get_type(context, 2), PLAIN_JSON_TYPE_OBJECT_START);
+    test_assert_eq(plain_json_get_token(context, 2)->value.container.child_count, 1);
+    const uint32_t key_index = plain_json_get_token(context, 3)->key_index;
+    test_assert_string_eq((const char *)plain_json_get_key(context, key_index), "name");
+
+    /* Arrays are kept as a whole, their objects are masked like the array */
+    test_assert_eq(plain_json_get_type(context, 5), PLAIN_JSON_TYPE_ARRAY_START);
+    test_assert_eq(plain_json_get_token(context, 5)->value.container.child_count, 3);
+    test_assert_eq(plain_json_get_token(context, 7)->type, PLAIN_JSON_TYPE_STRING);
+    test_assert_eq(plain_json_get_token(context, 9)->value.integer, 3);
+    test_assert_eq(plain_json_get_type(context, 10), PLAIN_JSON_TYPE_OBJECT_START);
+    test_assert_eq(plain_json_skip(context, 10), 12);
+
+    /* Everything below a path is kept, shared prefixes do not matter */
+    test_assert_eq(mask_parse("user.tags,user,blob.s,raw", text), PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(context), 16);
+    test_assert_eq(plain_json_get_token(context, 0)->value.container.child_count, 3);
+    uint32_t string_index = plain_json_get_token(context, 2)->value.string_index;
+    test_assert_string_eq((const char *)plain_json_get_string(context, string_index), "}]\"[{");
+    string_index = plain_json_get_token(context, 14)->value.string_index;
+    test_assert_string_eq(
+        (const char *)plain_json_get_string(context, string_index), "\xC3\xA9\\"
+    );
+
+    test_assert_eq(
+        mask_parse("key\\.with\\,separators", "{\"key.with,separators\": 1}"), PLAIN_JSON_DONE
+    );
+    test_assert_eq(plain_json_get_token_count(context), 3);
+
+    /* Skipped scalars are validated as if they were kept */
+    const char *invalid[] = { "{\"x\": tru}", "{\"x\": nul, \"id\": 1}", "{\"x\": 01}",
+                              "{\"x\": 1.}", "{\"x\": -, \"id\": 1}", "{\"x\": 1e}",
+                              "{\"x\": \"\\q\"}", "{\"x\": \"\x01\"}", "{\"x\": 1x}" };
+    for (uint32_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+        const plain_json_ErrorType expected = mask_parse("x", invalid[i]);
+        test_assert_ne(expected, PLAIN_JSON_DONE);
+        test_assert_eq(mask_parse("id", invalid[i]), expected);
+    }
+
+    /* Skipped containers only have to be balanced, their contents are not validated */
+    test_assert_eq(mask_parse("id", "{\"x\": [1, {\"a\": }], \"id\": 1}"), PLAIN_JSON_DONE);
+    test_assert_eq(mask_parse("y", "{\"x\": [tru, @@], \"y\": 1}"), PLAIN_JSON_DONE);
+    test_assert_eq(mask_parse("y", "{\"x\": {1: 2}, \"y\": 1}"), PLAIN_JSON_DONE);
+    test_assert_eq(mask_parse("id", "{\"x\": [1}, \"id\": 1}"), PLAIN_JSON_ERROR_ILLEGAL_CHAR);
+    test_assert_eq(
+        mask_parse("id", "{\"x\": \"1, \\\"id\\\": 1}"), PLAIN_JSON_ERROR_STRING_UNTERMINATED
+    );
+    test_assert_eq(mask_parse("id", "{\"id\": 1, \"x\": [[1], 2"), PLAIN_JSON_ERROR_UNEXPECTED_EOF);
+    test_assert_eq(mask_parse("id", "{\"x\": , \"id\": 1}"), PLAIN_JSON_ERROR_ILLEGAL_CHAR);
+}
+
+TEST(query, invalid_mask) {
+    const char *masks[] = { "", ",", "a,", ".a", "a..b", "a.,b" };
+    for (uint32_t i = 0; i < sizeof(masks) / sizeof(masks[0]); ++i) {
+        test_assert_eq(mask_parse(masks[i], "{}"), PLAIN_JSON_ERROR_MASK_INVALID);
+    }
+}
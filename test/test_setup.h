@@ -31,6 +31,7 @@ static plain_json_Context *context = NULL;
 
 static void test_finalize(void) {
     plain_json_free(context);
+    context = NULL;
 }
 
 #endif
@@ -0,0 +1,122 @@
+#define TEST_IMPLEMENTATION
+#include <test/test.h>
+
+/* The classifiers are internal, so this suite is built on its own */
+#define PLAIN_JSON_IMPLEMENTATION
+#include <plain_json.h>
+
+#include <stdlib.h>
+
+SUIT(simd, NULL, NULL);
+
+#define BLOCK_SIZE  64
+#define BLOCK_COUNT 4096
+
+/* Every classifier compiled in and supported by this CPU, the scalar one first */
+static uint32_t get_classifiers(plain_json_ClassifyFunc *classifiers) {
+    uint32_t count = 0;
+    classifiers[count++] = plain_json_intern_classify_scalar;
+
+#ifdef PLAIN_JSON_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        classifiers[count++] = plain_json_intern_classify_sse2;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        classifiers[count++] = plain_json_intern_classify_avx2;
+    }
+    if (__builtin_cpu_supports("avx512bw")) {
+        classifiers[count++] = plain_json_intern_classify_avx512;
+    }
+#endif
+
+    return count;
+}
+
+/* Random blocks, mostly drawn from the characters that matter to the classifier */
+static void fill_block(uint8_t *block, uint32_t index) {
+    static const uint8_t special[] = { ' ',  '\t', '\n', '\r', '"',  '\\', '{',  '}',  '[',  ']',
+                                       ',',  ':',  0x00, 0x1F, 0x20, 0x7F, 0x80, 0xFF, ';',  '=',
+                                       0x5B, 0x7B, 0x0B, 0x0C, 'a',  '0' };
+
+    for (uint32_t i = 0; i < BLOCK_SIZE; ++i) {
+        switch (index % 4) {
+        case 0:
+            /* Every byte value, in order */
+            block[i] = (uint8_t)((index / 4 % 4) * BLOCK_SIZE + i);
+            break;
+        case 1:
+            block[i] = (uint8_t)rand();
+            break;
+        case 2:
+            block[i] = special[rand() % sizeof(special)];
+            break;
+        default:
+            /* A single character, in the first, last or every position */
+            block[i] = (i == 0 || i == BLOCK_SIZE - 1 || index % 8 == 3)
+                           ? special[index / 8 % sizeof(special)]
+                           : 'x';
+            break;
+        }
+    }
+}
+
+TEST(simd, classifiers_agree) {
+    plain_json_ClassifyFunc classifiers[4];
+    const uint32_t count = get_classifiers(classifiers);
+
+    srand(1);
+    for (uint32_t index = 0; index < BLOCK_COUNT; ++index) {
+        uint8_t block[BLOCK_SIZE];
+        fill_block(block, index);
+
+        plain_json_BlockMask expected;
+        classifiers[0](block, &expected);
+
+        for (uint32_t i = 1; i < count; ++i) {
+            plain_json_BlockMask mask;
+            classifiers[i](block, &mask);
+
+            test_assert_eq(mask.blank, expected.blank);
+            test_assert_eq(mask.quote, expected.quote);
+            test_assert_eq(mask.backslash, expected.backslash);
+            test_assert_eq(mask.control, expected.control);
+            test_assert_eq(mask.structural, expected.structural);
+            test_assert_eq(mask.non_ascii, expected.non_ascii);
+        }
+    }
+}
+
+TEST(simd, scalar_classifier) {
+    uint8_t block[BLOCK_SIZE];
+    for (uint32_t i = 0; i < BLOCK_SIZE; ++i) {
+        block[i] = "{\"a\\\"\": [1,\t2]}\r\n\x01\x80 "[i % 20];
+    }
+
+    plain_json_BlockMask mask;
+    plain_json_intern_classify_scalar(block, &mask);
+
+    for (uint32_t i = 0; i < BLOCK_SIZE; ++i) {
+        const uint8_t c = block[i];
+        const uint64_t bit = (uint64_t)1 << i;
+
+        test_assert_eq((mask.blank & bit) != 0, c == ' ' || c == '\t' || c == '\n' || c == '\r');
+        test_assert_eq((mask.quote & bit) != 0, c == '"');
+        test_assert_eq((mask.backslash & bit) != 0, c == '\\');
+        test_assert_eq((mask.control & bit) != 0, c < 0x20);
+        test_assert_eq(
+            (mask.structural & bit) != 0,
+            c == '{' || c == '}' || c == '[' || c == ']' || c == ',' || c == ':'
+        );
+        test_assert_eq((mask.non_ascii & bit) != 0, c >= 0x80);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (!test_init(argc, argv)) {
+        return -1;
+    }
+    test_run_all();
+    test_exit();
+    return 0;
+}
@@ -0,0 +1,265 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "test_setup.h"
+
+SUIT(string, NULL, test_finalize);
+
+/* Parse '{"key": "<raw>"}' and compare the key and value against their decoded contents */
+#define TEST_STRING(name, parse_flags, raw, expected)                                           \
+    TEST(string, name) {                                                                        \
+        const char *text = "{\"key\": \"" raw "\"}";                                            \
+        plain_json_ErrorType status = PLAIN_JSON_DONE;                                          \
+        plain_json_Options options = { 0 };                                                     \
+        options.flags = parse_flags;                                                            \
+        context = plain_json_parse_with_options(                                                \
+            alloc_config, options, (uint8_t *)text, strlen(text), &status                       \
+        );                                                                                      \
+        test_assert_eq(status, PLAIN_JSON_DONE);                                                \
+        const plain_json_Token *token = plain_json_get_token(context, 1);                       \
+        test_assert_eq(plain_json_get_string_length(context, token->key_index), 3);             \
+        test_assert_eq(memcmp(plain_json_get_key(context, token->key_index), "key", 3), 0);     \
+                                                                                                \
+        const uint32_t index = token->value.string_index;                                       \
+        const uint32_t length = plain_json_get_string_length(context, index);                   \
+        const uint8_t *value = plain_json_get_string(context, index);                           \
+        test_assert_eq(length, sizeof(expected) - 1);                                           \
+        test_assert_eq(memcmp(value, expected, length), 0);                                     \
+    }
+
+TEST_STRING(copy_plain, 0, "plain", "plain")
+TEST_STRING(copy_escaped, 0, "tab\\there", "tab\there")
+TEST_STRING(copy_empty, 0, "", "")
+TEST_STRING(zero_copy_plain, PLAIN_JSON_FLAG_ZERO_COPY, "plain", "plain")
+TEST_STRING(zero_copy_escaped, PLAIN_JSON_FLAG_ZERO_COPY, "tab\\there", "tab\there")
+TEST_STRING(zero_copy_empty, PLAIN_JSON_FLAG_ZERO_COPY, "", "")
+TEST_STRING(
+    zero_copy_long, PLAIN_JSON_FLAG_ZERO_COPY,
+    "a string that spans more than a single block of sixty four bytes \xF0\x9F\x90\x88",
+    "a string that spans more than a single block of sixty four bytes \xF0\x9F\x90\x88"
+)
+
+/* Escapes decoding to more than the 64 byte cache they are decoded into */
+#define REPEAT_10(text)  text text text text text text text text text text
+#define REPEAT_100(text) REPEAT_10(REPEAT_10(text))
+
+TEST_STRING(copy_unicode_ascii, 0, "\\u0041", "A")
+TEST_STRING(
+    copy_simple_escapes, 0, "\\\" \\\\ \\/ \\b \\f \\n \\r \\t", "\" \\ / \b \f \n \r \t"
+)
+TEST_STRING(copy_escapes_long, 0, REPEAT_100("\\n"), REPEAT_100("\n"))
+TEST_STRING(zero_copy_unicode_ascii, PLAIN_JSON_FLAG_ZERO_COPY, "\\u0041", "A")
+TEST_STRING(
+    zero_copy_simple_escapes, PLAIN_JSON_FLAG_ZERO_COPY,
+    "\\\" \\\\ \\/ \\b \\f \\n \\r \\t", "\" \\ / \b \f \n \r \t"
+)
+TEST_STRING(zero_copy_escapes_long, PLAIN_JSON_FLAG_ZERO_COPY, REPEAT_100("\\n"), REPEAT_100("\n"))
+
+TEST(string, many_strings) {
+    /* Enough strings of different lengths for the string buffer to grow a number of times */
+    const uint32_t count = 2000;
+    char *text = malloc(count * 48 + 2);
+    uint32_t offset = 0;
+    text[offset++] = '[';
+    for (uint32_t i = 0; i < count; i++) {
+        offset += sprintf(text + offset, "%s\"%u\\t%.*s\"", i == 0 ? "" : ",", i, i % 32,
+                          "abcdefghijklmnopqrstuvwxyz012345");
+    }
+    text[offset++] = ']';
+
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    context = plain_json_parse(alloc_config, (uint8_t *)text, offset, &status);
+    free(text);
+    test_assert_eq(status, PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(context), count + 2);
+
+    for (uint32_t i = 0; i < count; i++) {
+        char expected[48];
+        const int length =
+            sprintf(expected, "%u\t%.*s", i, i % 32, "abcdefghijklmnopqrstuvwxyz012345");
+
+        const uint32_t index = plain_json_get_token(context, 1 + i)->value.string_index;
+        test_assert_eq(plain_json_get_string_length(context, index), (uint32_t)length);
+        test_assert_string_eq((const char *)plain_json_get_string(context, index), expected);
+    }
+}
+
+TEST(string, zero_copy_references_input) {
+    const char *text = "[\"plain\", \"esc\\\"aped\"]";
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    plain_json_Options options = { 0 };
+    options.flags = PLAIN_JSON_FLAG_ZERO_COPY;
+
+    context = plain_json_parse_with_options(
+        alloc_config, options, (uint8_t *)text, strlen(text), &status
+    );
+    test_assert_eq(status, PLAIN_JSON_DONE);
+
+    /* Only the string with escapes is copied */
+    const plain_json_Token *plain = plain_json_get_token(context, 1);
+    test_assert_eq(plain_json_get_string(context, plain->value.string_index), (uint8_t *)text + 2);
+
+    const plain_json_Token *escaped = plain_json_get_token(context, 2);
+    const uint8_t *value = plain_json_get_string(context, escaped->value.string_index);
+    test_assert_ne(value, (uint8_t *)text + 11);
+    test_assert_string_eq((const char *)value, "esc\"aped");
+}
+
+TEST(string, in_situ) {
+    char text[] = "{\"k\\u00e9y\": [\"plain\", \"a\\\\b\\nc\", \"\\uD83D\\uDC08\"]}";
+    const plain_json_Options options = { 0 };
+
+    context = plain_json_create(alloc_config);
+    test_assert_eq(
+        plain_json_parse_in_situ(context, options, (uint8_t *)text, strlen(text)), PLAIN_JSON_DONE
+    );
+
+    /* Strings are decoded into the input buffer and NUL terminated */
+    const plain_json_Token *token = plain_json_get_token(context, 1);
+    const uint8_t *key = plain_json_get_key(context, token->key_index);
+    test_assert_eq(key, (uint8_t *)text + 2);
+    test_assert_string_eq((const char *)key, "k\xC3\xA9y");
+    test_assert_eq(plain_json_get_string_length(context, token->key_index), 4);
+
+    const char *expected[] = { "plain", "a\\b\nc", "\xF0\x9F\x90\x88" };
+    for (uint32_t i = 0; i < 3; i++) {
+        token = plain_json_get_token(context, 2 + i);
+        test_assert_string_eq(
+            (const char *)plain_json_get_string(context, token->value.string_index), expected[i]
+        );
+    }
+}
+
+TEST(string, in_situ_private) {
+    char text[] = "[\"a\\nb\"]";
+    const plain_json_Options options = { .flags = 1U << 31 };
+
+    /* In situ decoding is only enabled by "plain_json_parse_in_situ()", never by a flag */
+    context = plain_json_create(alloc_config);
+    test_assert_eq(
+        plain_json_parse_into(context, options, (uint8_t *)text, strlen(text)), PLAIN_JSON_DONE
+    );
+    test_assert_string_eq(text, "[\"a\\nb\"]");
+
+    const plain_json_Token *token = plain_json_get_token(context, 1);
+    const uint8_t *value = plain_json_get_string(context, token->value.string_index);
+    test_assert_ne(value, (uint8_t *)text + 2);
+    test_assert_string_eq((const char *)value, "a\nb");
+
+    /* Nor does it stick to the context */
+    test_assert_eq(
+        plain_json_parse_in_situ(context, options, (uint8_t *)text, strlen(text)), PLAIN_JSON_DONE
+    );
+    test_assert_eq(
+        plain_json_parse_into(context, options, (uint8_t *)"[\"c\"]", 5), PLAIN_JSON_DONE
+    );
+    token = plain_json_get_token(context, 1);
+    test_assert_string_eq(
+        (const char *)plain_json_get_string(context, token->value.string_index), "c"
+    );
+}
+
+TEST(string, embedded_nul) {
+    const char *text = "{\"a\\u0000b\": \"\\u0000\"}";
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+
+    context = plain_json_parse(alloc_config, (uint8_t *)text, strlen(text), &status);
+    test_assert_eq(status, PLAIN_JSON_DONE);
+
+    const plain_json_Token *token = plain_json_get_token(context, 1);
+    const plain_json_String key = plain_json_get_key_view(context, token->key_index);
+    test_assert_eq(key.length, 3);
+    test_assert_eq(memcmp(key.data, "a\0b", 3), 0);
+
+    const plain_json_String value = plain_json_get_string_view(context, token->value.string_index);
+    test_assert_eq(value.length, 1);
+    test_assert_eq(value.data[0], '\0');
+}
+
+TEST(string, key_equals) {
+    const char *text = "{\"name\": 1, \"na\\u006De\": 2, \"names\": 3}";
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+
+    context = plain_json_parse(alloc_config, (uint8_t *)text, strlen(text), &status);
+    test_assert_eq(status, PLAIN_JSON_DONE);
+
+    const uint8_t *name = (const uint8_t *)"name";
+    const bool expected[] = { true, true, false };
+    for (uint32_t i = 0; i < 3; i++) {
+        const uint32_t key_index = plain_json_get_token(context, 1 + i)->key_index;
+        test_assert_eq(plain_json_key_equals(context, key_index, name, 4), expected[i]);
+    }
+    test_assert_eq(plain_json_key_equals(context, PLAIN_JSON_NO_KEY, name, 4), false);
+}
+
+TEST(string, intern_keys) {
+    /* 100 objects with the same 100 keys, which is enough to grow the table a few times */
+    char *text = malloc(100 * 100 * 16 + 16);
+    uint32_t length = 0;
+    text[length++] = '[';
+    for (uint32_t i = 0; i < 100; i++) {
+        if (i > 0) {
+            text[length++] = ',';
+        }
+        text[length++] = '{';
+        for (uint32_t k = 0; k < 100; k++) {
+            length += sprintf(text + length, "%s\"key_%u\":%u", k == 0 ? "" : ",", k, i);
+        }
+        text[length++] = '}';
+    }
+    text[length++] = ']';
+
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    plain_json_Options options = { 0 };
+    options.flags = PLAIN_JSON_FLAG_INTERN_KEYS;
+    context =
+        plain_json_parse_with_options(alloc_config, options, (uint8_t *)text, length, &status);
+    free(text);
+    test_assert_eq(status, PLAIN_JSON_DONE);
+
+    /* The n-th key of each object has the same index */
+    for (uint32_t k = 0; k < 100; k++) {
+        const uint32_t first = plain_json_get_token(context, 2 + k)->key_index;
+        const uint32_t last = plain_json_get_token(context, 2 + 99 * 102 + k)->key_index;
+        test_assert_eq(first, last);
+    }
+
+    const plain_json_Token *token = plain_json_get_token(context, 2 + 99 * 102 + 42);
+    test_assert_string_eq((const char *)plain_json_get_key(context, token->key_index), "key_42");
+    test_assert_eq(token->value.integer, 99);
+}
+
+TEST(string, key_hash) {
+    const char *text =
+        "{\"a\": {\"a\": 1, \"long key with \\u00e9scapes\": 2, \"\": 3}, \"b\": \"a\"}";
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    plain_json_Options options = { 0 };
+
+    for (uint32_t i = 0; i < 3; i++) {
+        const uint32_t flags[] = { 0, PLAIN_JSON_FLAG_ZERO_COPY, PLAIN_JSON_FLAG_INTERN_KEYS };
+        options.flags = flags[i];
+        plain_json_free(context);
+        context = plain_json_parse_with_options(
+            alloc_config, options, (uint8_t *)text, strlen(text), &status
+        );
+        test_assert_eq(status, PLAIN_JSON_DONE);
+
+        const uint32_t outer = plain_json_get_token(context, 1)->key_index;
+        const uint32_t inner = plain_json_get_token(context, 2)->key_index;
+        const uint32_t escaped = plain_json_get_token(context, 3)->key_index;
+        const uint32_t empty = plain_json_get_token(context, 4)->key_index;
+
+        test_assert_eq(plain_json_get_key_hash(context, outer), plain_json_hash((uint8_t *)"a", 1));
+        test_assert_eq(plain_json_get_key_hash(context, inner), plain_json_hash((uint8_t *)"a", 1));
+        test_assert_eq(
+            plain_json_get_key_hash(context, escaped),
+            plain_json_hash((uint8_t *)"long key with \xc3\xa9scapes", 22)
+        );
+        test_assert_eq(plain_json_get_key_hash(context, empty), plain_json_hash((uint8_t *)"", 0));
+        test_assert_ne(
+            plain_json_get_key_hash(context, outer),
+            plain_json_get_key_hash(context, plain_json_get_token(context, 6)->key_index)
+        );
+        test_assert_eq(plain_json_get_key_hash(context, PLAIN_JSON_NO_KEY), 0);
+    }
+}
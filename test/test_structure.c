@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "test_setup.h"
+
+SUIT(structure, NULL, test_finalize);
+
+/* Alternating objects and arrays, "{"a":[{"a":[...]}]}", "depth" containers deep */
+static char *make_nested(uint32_t depth) {
+    char *text = malloc(depth * 6 + 1);
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < depth; ++i) {
+        if (i % 2 == 0) {
+            memcpy(text + offset, "{\"a\":", 5);
+            offset += 5;
+        } else {
+            text[offset++] = '[';
+        }
+    }
+    for (uint32_t i = depth; i > 0; --i) {
+        text[offset++] = (i - 1) % 2 == 0 ? '}' : ']';
+    }
+    text[offset] = '\0';
+    return text;
+}
+
+TEST(structure, default_depth) {
+    char *text = make_nested(PLAIN_JSON_OPTION_MAX_DEPTH + 1);
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    context = plain_json_parse(alloc_config, (uint8_t *)text, strlen(text), &status);
+    free(text);
+
+    test_assert_eq(status, PLAIN_JSON_ERROR_NESTING_TOO_DEEP);
+}
+
+TEST(structure, deep_nesting) {
+    char *text = make_nested(5000);
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    plain_json_Options options = { 0 };
+    options.max_depth = 5000;
+
+    context = plain_json_parse_with_options(
+        alloc_config, options, (uint8_t *)text, strlen(text), &status
+    );
+
+    test_assert_eq(status, PLAIN_JSON_DONE);
+    test_assert_eq(plain_json_get_token_count(context), 10000);
+    test_assert_eq(plain_json_get_type(context, 4999), PLAIN_JSON_TYPE_ARRAY_START);
+    test_assert_eq(plain_json_get_type(context, 5000), PLAIN_JSON_TYPE_ARRAY_END);
+    test_assert_eq(plain_json_get_type(context, 9999), PLAIN_JSON_TYPE_OBJECT_END);
+
+    /* One level less than the document needs */
+    options.max_depth = 4999;
+    status = plain_json_parse_into(context, options, (uint8_t *)text, strlen(text));
+    free(text);
+
+    test_assert_eq(status, PLAIN_JSON_ERROR_NESTING_TOO_DEEP);
+}
+
+TEST(structure, fixed_depth) {
+    static uint8_t memory[1024], tokens[1024 * 32], strings[1024];
+    char *text = make_nested(200);
+    plain_json_Options options = { 0 };
+    options.max_depth = 1000;
+
+    plain_json_Context *fixed = plain_json_create_fixed(
+        memory, sizeof(memory), tokens, sizeof(tokens), strings, sizeof(strings)
+    );
+    test_assert_ne(fixed, NULL);
+
+    /* Fixed contexts never allocate, so they stop at the inline capacity */
+    plain_json_ErrorType status =
+        plain_json_parse_into(fixed, options, (uint8_t *)text, strlen(text));
+    free(text);
+
+    test_assert_eq(status, PLAIN_JSON_ERROR_NESTING_TOO_DEEP);
+
+    text = make_nested(128);
+    status = plain_json_parse_into(fixed, options, (uint8_t *)text, strlen(text));
+    free(text);
+
+    test_assert_eq(status, PLAIN_JSON_DONE);
+}
+
+TEST(structure, skip_subtree) {
+    const char *text = "{\"a\": [1, {\"b\": []}, 3], \"c\": {}, \"d\": 4}";
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    plain_json_Options options = { 0 };
+
+    for (uint32_t i = 0; i < 2; ++i) {
+        options.flags = i == 0 ? 0 : PLAIN_JSON_FLAG_COMPACT_TOKENS;
+        plain_json_free(context);
+        context = plain_json_parse_with_options(
+            alloc_config, options, (uint8_t *)text, strlen(text), &status
+        );
+
+        test_assert_eq(status, PLAIN_JSON_DONE);
+        test_assert_eq(plain_json_get_token_count(context), 13);
+        test_assert_eq(plain_json_skip(context, 0), 13);
+        test_assert_eq(plain_json_skip(context, 1), 9);
+        test_assert_eq(plain_json_skip(context, 2), 3);
+        test_assert_eq(plain_json_skip(context, 3), 7);
+        test_assert_eq(plain_json_skip(context, 9), 11);
+        test_assert_eq(plain_json_skip(context, 13), 13);
+        test_assert_eq(plain_json_get_token(context, 1)->value.container.end_index, 8);
+        test_assert_eq(plain_json_get_token(context, 0)->value.container.child_count, 3);
+        test_assert_eq(plain_json_get_token(context, 1)->value.container.child_count, 3);
+        test_assert_eq(plain_json_get_token(context, 4)->value.container.child_count, 0);
+    }
+
+    /* The array is never closed */
+    text = "[[1], [2";
+    status = plain_json_parse_into(context, options, (uint8_t *)text, strlen(text));
+
+    test_assert_eq(status, PLAIN_JSON_ERROR_UNEXPECTED_EOF);
+    test_assert_eq(plain_json_skip(context, 1), 4);
+    test_assert_eq(plain_json_skip(context, 0), plain_json_get_token_count(context));
+    test_assert_eq(plain_json_skip(context, 4), plain_json_get_token_count(context));
+}
+
+TEST(structure, cursor) {
+    const char *text = "{\"a\": [1, {\"b\": []}, 3], \"c\": {}, \"d\": 4}";
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    context = plain_json_parse(alloc_config, (uint8_t *)text, strlen(text), &status);
+    test_assert_eq(status, PLAIN_JSON_DONE);
+
+    plain_json_Cursor cursor = { 0 };
+    test_assert_eq(plain_json_cursor_root(context, &cursor), true);
+    test_assert_eq(plain_json_cursor_next_sibling(context, &cursor), false);
+    test_assert_eq(plain_json_cursor_parent(context, &cursor), false);
+
+    /* "a" */
+    test_assert_eq(plain_json_cursor_first_child(context, &cursor), true);
+    test_assert_eq(cursor.index, 1);
+    test_assert_eq(cursor.parent, 0);
+    test_assert_eq(cursor.depth, 1);
+
+    /* "a"[1] */
+    test_assert_eq(plain_json_cursor_first_child(context, &cursor), true);
+    test_assert_eq(plain_json_cursor_next_sibling(context, &cursor), true);
+    test_assert_eq(cursor.index, 3);
+    test_assert_eq(cursor.depth, 2);
+
+    /* "a"[1]."b" has no children */
+    test_assert_eq(plain_json_cursor_first_child(context, &cursor), true);
+    test_assert_eq(plain_json_cursor_first_child(context, &cursor), false);
+    test_assert_eq(plain_json_cursor_next_sibling(context, &cursor), false);
+    test_assert_eq(cursor.index, 4);
+    test_assert_eq(cursor.depth, 3);
+
+    test_assert_eq(plain_json_cursor_parent(context, &cursor), true);
+    test_assert_eq(plain_json_cursor_next_sibling(context, &cursor), true);
+    test_assert_eq(cursor.index, 7);
+    test_assert_eq(cursor.parent, 1);
+
+    /* Back to "a", then on to "d" */
+    test_assert_eq(plain_json_cursor_parent(context, &cursor), true);
+    test_assert_eq(cursor.index, 1);
+    test_assert_eq(cursor.parent, 0);
+    test_assert_eq(cursor.depth, 1);
+    test_assert_eq(plain_json_cursor_next_sibling(context, &cursor), true);
+    test_assert_eq(plain_json_cursor_next_sibling(context, &cursor), true);
+    test_assert_eq(cursor.index, 11);
+    test_assert_eq(plain_json_cursor_next_sibling(context, &cursor), false);
+
+    test_assert_eq(plain_json_cursor_parent(context, &cursor), true);
+    test_assert_eq(cursor.index, 0);
+    test_assert_eq(cursor.parent, PLAIN_JSON_NO_KEY);
+    test_assert_eq(cursor.depth, 0);
+}
+
+TEST(structure, object_get) {
+    const char *text = "{\"a\": 1, \"b\": {\"c\": 2}, \"a\": 3}";
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    context = plain_json_parse(alloc_config, (uint8_t *)text, strlen(text), &status);
+    test_assert_eq(status, PLAIN_JSON_DONE);
+
+    test_assert_eq(plain_json_object_get(context, 0, (const uint8_t *)"a", 1), 1);
+    test_assert_eq(plain_json_object_get(context, 0, (const uint8_t *)"b", 1), 2);
+    test_assert_eq(plain_json_object_get(context, 0, (const uint8_t *)"c", 1), PLAIN_JSON_NO_KEY);
+    test_assert_eq(plain_json_object_get(context, 2, (const uint8_t *)"c", 1), 3);
+    test_assert_eq(plain_json_object_get(context, 1, (const uint8_t *)"a", 1), PLAIN_JSON_NO_KEY);
+
+    /* Large enough to be indexed */
+    char large[4096];
+    uint32_t offset = 0;
+    large[offset++] = '{';
+    for (uint32_t i = 0; i < 100; ++i) {
+        offset += sprintf(large + offset, "%s\"key%u\": %u", i == 0 ? "" : ", ", i, i);
+    }
+    large[offset++] = '}';
+
+    status = plain_json_parse_into(context, (plain_json_Options){ 0 }, (uint8_t *)large, offset);
+    test_assert_eq(status, PLAIN_JSON_DONE);
+
+    for (uint32_t round = 0; round < 2; ++round) {
+        for (uint32_t i = 0; i < 100; ++i) {
+            char key[16];
+            const int length = sprintf(key, "key%u", i);
+            const uint32_t index = plain_json_object_get(context, 0, (uint8_t *)key, length);
+            test_assert_eq(index, i + 1);
+            test_assert_eq(plain_json_get_token(context, index)->value.integer, i);
+        }
+    }
+    test_assert_eq(
+        plain_json_object_get(context, 0, (const uint8_t *)"key100", 6), PLAIN_JSON_NO_KEY
+    );
+}
+
+TEST(structure, array_get) {
+    const char *text = "[[0, 1, 2], [{}, [1, [2]], 3, \"x\"]]";
+    plain_json_ErrorType status = PLAIN_JSON_DONE;
+    context = plain_json_parse(alloc_config, (uint8_t *)text, strlen(text), &status);
+    test_assert_eq(status, PLAIN_JSON_DONE);
+
+    test_assert_eq(plain_json_array_get(context, 0, 0), 1);
+    test_assert_eq(plain_json_array_get(context, 0, 1), 6);
+    test_assert_eq(plain_json_array_get(context, 0, 2), PLAIN_JSON_NO_KEY);
+    test_assert_eq(plain_json_array_get(context, 1, 2), 4);
+    test_assert_eq(plain_json_array_get(context, 6, 1), 9);
+    test_assert_eq(plain_json_array_get(context, 6, 3), 16);
+    test_assert_eq(plain_json_array_get(context, 7, 0), PLAIN_JSON_NO_KEY);
+}
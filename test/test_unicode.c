@@ -31,6 +31,20 @@ TEST_UNICODE(utf8_four_valid, PLAIN_JSON_DONE, "\xF0\x9F\x90\x88") /* 🐈 */
 
 TEST_UNICODE(utf8_surrogate_high, PLAIN_JSON_ERROR_STRING_UTF8_HAS_SURROGATE, "\xED\xBF\xBF")
 TEST_UNICODE(utf8_surrogate_low, PLAIN_JSON_ERROR_STRING_UTF8_HAS_SURROGATE, "\xED\xB0\xB0")
+/* U+0360 shares its bit pattern with the surrogate range, but is a two byte sequence */
+TEST_UNICODE(utf8_two_not_surrogate, PLAIN_JSON_DONE, "\xCD\xA0")
+
+/* Longer strings are validated in blocks, errors must be found across block boundaries */
+#define UTF8_FILL "\xE6\x97\xA5\xE6\x9C\xAC\xF0\x9F\x98\x80" "abcdefghijklmnopqrstuvwxyz"
+TEST_UNICODE(utf8_long_valid, PLAIN_JSON_DONE, UTF8_FILL UTF8_FILL "\xF0\x9F\x90\x88")
+TEST_UNICODE(utf8_long_truncated, PLAIN_JSON_ERROR_STRING_UTF8_INVALID, UTF8_FILL "0\xF0\x9F\x90")
+TEST_UNICODE(
+    utf8_long_surrogate, PLAIN_JSON_ERROR_STRING_UTF8_HAS_SURROGATE, UTF8_FILL "xyz\xED\xA0\x80"
+)
+TEST_UNICODE(
+    utf8_long_overlong, PLAIN_JSON_ERROR_STRING_UTF8_INVALID, UTF8_FILL UTF8_FILL "\xE0\x80\xAF"
+)
+#undef UTF8_FILL
 
 /* UTF-16 */
 TEST_UNICODE(
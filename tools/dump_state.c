@@ -11,14 +11,16 @@
 #define PLAIN_JSON_IMPLEMENTATION
 #include <plain_json.h>
 
-#define PLAIN_JSON_STATE_IS_FIRST_TOKEN 0x01
-#define PLAIN_JSON_STATE_IS_ROOT        0x02
-
-#define PLAIN_JSON_STATE_NEEDS_KEY         0x04
-#define PLAIN_JSON_STATE_NEEDS_COMMA       0x08
-#define PLAIN_JSON_STATE_NEEDS_VALUE       0x10
-#define PLAIN_JSON_STATE_NEEDS_ARRAY_VALUE 0x20
-#define PLAIN_JSON_STATE_NEEDS_COLON       0x40
+#define PLAIN_JSON_STATE_ROOT_START   0
+#define PLAIN_JSON_STATE_ROOT_END     1
+#define PLAIN_JSON_STATE_OBJECT_START 2
+#define PLAIN_JSON_STATE_OBJECT_KEY   3
+#define PLAIN_JSON_STATE_OBJECT_COLON 4
+#define PLAIN_JSON_STATE_OBJECT_VALUE 5
+#define PLAIN_JSON_STATE_OBJECT_COMMA 6
+#define PLAIN_JSON_STATE_ARRAY_START  7
+#define PLAIN_JSON_STATE_ARRAY_VALUE  8
+#define PLAIN_JSON_STATE_ARRAY_COMMA  9
 
 static void print_error(plain_json_Context *context, uintptr_t position, plain_json_ErrorType type) {
     uint32_t line = 0, offset = 0;
@@ -27,51 +29,62 @@ static void print_error(plain_json_Context *context, uintptr_t position, plain_j
 }
 __attribute__((unused)) static void
 dump_state(plain_json_Context *context, char *buffer, int buffer_size) {
-    uint32_t state = context->depth_buffer[context->depth_buffer_index];
-    char *state_as_string = NULL;
-    uint32_t bitcount = 0;
-    uint32_t offset = 0;
+    uint32_t state = context->state;
+    char *state_as_string = "unknown";
+
+    switch (state) {
+    case PLAIN_JSON_STATE_ROOT_START:
+        state_as_string = "root_start";
+        break;
+    case PLAIN_JSON_STATE_ROOT_END:
+        state_as_string = "root_end";
+        break;
+    case PLAIN_JSON_STATE_OBJECT_START:
+        state_as_string = "object_start";
+        break;
+    case PLAIN_JSON_STATE_OBJECT_KEY:
+        state_as_string = "object_key";
+        break;
+    case PLAIN_JSON_STATE_OBJECT_COLON:
+        state_as_string = "object_colon";
+        break;
+    case PLAIN_JSON_STATE_OBJECT_VALUE:
+        state_as_string = "object_value";
+        break;
+    case PLAIN_JSON_STATE_OBJECT_COMMA:
+        state_as_string = "object_comma";
+        break;
+    case PLAIN_JSON_STATE_ARRAY_START:
+        state_as_string = "array_start";
+        break;
+    case PLAIN_JSON_STATE_ARRAY_VALUE:
+        state_as_string = "array_value";
+        break;
+    case PLAIN_JSON_STATE_ARRAY_COMMA:
+        state_as_string = "array_comma";
+        break;
+    }
 
-    for (int i = 0; i < 31; i++) {
-        uint32_t state_bit = state & (1 << i);
+    snprintf(buffer, buffer_size, "%s", state_as_string);
+}
 
-        if (state_bit == 0) {
-            continue;
-        }
+#define BUFFER_SIZE 1024
 
-        if (bitcount > 0) {
-            offset += snprintf(buffer + offset, buffer_size - offset, " | ");
-        }
-        bitcount++;
-
-        switch (state_bit) {
-        case PLAIN_JSON_STATE_NEEDS_KEY:
-            state_as_string = "needs_key";
-            break;
-        case PLAIN_JSON_STATE_NEEDS_VALUE:
-            state_as_string = "needs_value";
-            break;
-        case PLAIN_JSON_STATE_NEEDS_ARRAY_VALUE:
-            state_as_string = "needs_array_value";
-            break;
-        case PLAIN_JSON_STATE_NEEDS_COMMA:
-            state_as_string = "needs_comma";
-            break;
-        case PLAIN_JSON_STATE_NEEDS_COLON:
-            state_as_string = "needs_colon";
-            break;
-        case PLAIN_JSON_STATE_IS_ROOT:
-            state_as_string = "is_root";
-            break;
+// Strings may contain NUL characters, which are written as "\u0000"
+static uint32_t print_string(char *buffer, uint32_t buffer_size, plain_json_String string) {
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < string.length && offset + 7 < buffer_size; i++) {
+        if (string.data[i] == '\0') {
+            offset += snprintf(buffer + offset, buffer_size - offset, "\\u0000");
+        } else {
+            buffer[offset++] = (char)string.data[i];
         }
-
-        offset += snprintf(buffer + offset, buffer_size - offset, "%s", state_as_string);
     }
 
-    buffer[offset] = 0;
+    buffer[offset] = '\0';
+    return offset;
 }
 
-#define BUFFER_SIZE 1024
 static void dump(plain_json_Context *context, const plain_json_Token *token, uint32_t depth) {
     char buffer[BUFFER_SIZE] = { 0 };
 
@@ -84,23 +97,34 @@ static void dump(plain_json_Context *context, const plain_json_Token *token, uin
         snprintf(buffer + offset, BUFFER_SIZE, "%-12s", plain_json_type_to_string(token->type));
 
     if (token->key_index != PLAIN_JSON_NO_KEY) {
-        offset += snprintf(
-            buffer + offset, BUFFER_SIZE - offset, ": \"%s\"",
-            plain_json_get_key(context, token->key_index)
+        offset += snprintf(buffer + offset, BUFFER_SIZE - offset, ": \"");
+        offset += print_string(
+            buffer + offset, BUFFER_SIZE - offset, plain_json_get_key_view(context, token->key_index)
         );
+        offset += snprintf(buffer + offset, BUFFER_SIZE - offset, "\"");
     }
 
     if (token->type == PLAIN_JSON_TYPE_STRING) {
-        offset += snprintf(
-            buffer + offset, BUFFER_SIZE - offset, " = '%s'",
-            plain_json_get_string(context, token->value.string_index)
+        offset += snprintf(buffer + offset, BUFFER_SIZE - offset, " = '");
+        offset += print_string(
+            buffer + offset, BUFFER_SIZE - offset,
+            plain_json_get_string_view(context, token->value.string_index)
         );
+        offset += snprintf(buffer + offset, BUFFER_SIZE - offset, "'");
     }
 
     if (token->type == PLAIN_JSON_TYPE_INTEGER) {
         offset += snprintf(buffer + offset, BUFFER_SIZE - offset, " = '%lu'", token->value.integer);
     }
 
+    if (token->type == PLAIN_JSON_TYPE_FLOAT32) {
+        offset += snprintf(buffer + offset, BUFFER_SIZE - offset, " = '%.9g'", token->value.float32);
+    }
+
+    if (token->type == PLAIN_JSON_TYPE_FLOAT64) {
+        offset += snprintf(buffer + offset, BUFFER_SIZE - offset, " = '%.17g'", token->value.float64);
+    }
+
     /*dump_state(context, value_buffer, VALUE_BUFFER_SIZE);*/
     printf("%s\n", buffer);
 }